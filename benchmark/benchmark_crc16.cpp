@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "components/efs/crc16.h"
+
+namespace esphome::efs {
+namespace {
+
+std::string make_data(size_t size) {
+  std::string data;
+  data.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    data.push_back(static_cast<char>(i * 37 + 11));
+  }
+  return data;
+}
+
+void BM_Crc16PerByte(benchmark::State &state) {
+  const auto data = make_data(state.range(0));
+  for (auto _ : state) {
+    Crc16Calculator calc;
+    for (char c : data) {
+      calc.update(c);
+    }
+    benchmark::DoNotOptimize(calc.crc());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Crc16PerByte)->Arg(64)->Arg(1700)->Arg(8192);
+
+template<size_t Slices> void BM_Crc16Bulk(benchmark::State &state) {
+  const auto data = make_data(state.range(0));
+  for (auto _ : state) {
+    BaseCrc16Calculator<Slices> calc;
+    calc.update(data.data(), data.size());
+    benchmark::DoNotOptimize(calc.crc());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK_TEMPLATE(BM_Crc16Bulk, 1)->Arg(64)->Arg(1700)->Arg(8192);
+BENCHMARK_TEMPLATE(BM_Crc16Bulk, 4)->Arg(64)->Arg(1700)->Arg(8192);
+BENCHMARK_TEMPLATE(BM_Crc16Bulk, 8)->Arg(64)->Arg(1700)->Arg(8192);
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "components/efs/gcm.h"
+#include "test/telegram_corpus.h"
+
+namespace esphome::efs {
+namespace {
+
+constexpr std::array<uint8_t, 16> KEY{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                      0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+constexpr std::array<uint8_t, 17> AAD{0x30, 0xD0, 0xD1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7,
+                                      0xD8, 0xD9, 0xDA, 0xDB, 0xDC, 0xDD, 0xDE, 0xDF};
+
+// Decrypt and verify the encrypted corpus telegram in chunks as they are read from the UART
+void BM_DecryptTelegram(benchmark::State &state) {
+  const auto frame = testing::load_telegram("lu_smarty_encrypted.bin");
+  const auto *bytes = reinterpret_cast<const uint8_t *>(frame.data());
+  std::array<uint8_t, 12> iv{};
+  std::copy(&bytes[2], &bytes[10], iv.begin());
+  std::copy(&bytes[14], &bytes[18], &iv[8]);
+  const uint8_t *ciphertext = &bytes[18];
+  const size_t ciphertext_size = frame.size() - 18 - 12;
+  const uint8_t *tag = &bytes[frame.size() - 12];
+  const auto chunk_size = static_cast<size_t>(state.range(0));
+  std::vector<uint8_t> output(chunk_size + Gcm::MAX_HELD_BACK);
+
+  Gcm gcm;
+  gcm.set_key(KEY.data(), KEY.size());
+  for (auto _ : state) {
+    gcm.start(iv.data(), iv.size(), AAD.data(), AAD.size());
+    for (size_t offset = 0; offset < ciphertext_size; offset += chunk_size) {
+      gcm.decrypt(&ciphertext[offset], std::min(chunk_size, ciphertext_size - offset), output.data());
+    }
+    if (gcm.finish(output.data(), tag, 12) < 0) {
+      state.SkipWithError("Tag mismatch");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * ciphertext_size);
+}
+BENCHMARK(BM_DecryptTelegram)->Arg(16)->Arg(128)->Arg(1024);
+
+// Decrypt generated data of increasing size in 128 byte chunks, without checking the tag
+void BM_DecryptThroughput(benchmark::State &state) {
+  const std::vector<uint8_t> ciphertext(state.range(0), 0x5A);
+  const std::array<uint8_t, 12> iv{};
+  std::vector<uint8_t> output(128 + Gcm::MAX_HELD_BACK);
+
+  Gcm gcm;
+  gcm.set_key(KEY.data(), KEY.size());
+  for (auto _ : state) {
+    gcm.start(iv.data(), iv.size(), AAD.data(), AAD.size());
+    for (size_t offset = 0; offset < ciphertext.size(); offset += 128) {
+      gcm.decrypt(&ciphertext[offset], std::min<size_t>(128, ciphertext.size() - offset), output.data());
+    }
+    benchmark::DoNotOptimize(gcm.finish(output.data(), nullptr, 0));
+  }
+  state.SetBytesProcessed(state.iterations() * ciphertext.size());
+}
+BENCHMARK(BM_DecryptThroughput)->RangeMultiplier(4)->Range(256, 64 << 10);
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#include "components/efs/numeric_value.h"
+
+namespace esphome::efs {
+namespace {
+
+const std::array<const char *, 6> VALUES{"123456.789*kWh", "01.193*kW", "230.1*V", "12785.123*m3", "00004",
+                                         "0000000240*s"};
+
+void BM_Strtof(benchmark::State &state) {
+  for (auto _ : state) {
+    for (const char *value : VALUES) {
+      char *value_end{};
+      benchmark::DoNotOptimize(std::strtof(value, &value_end));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * VALUES.size());
+}
+BENCHMARK(BM_Strtof);
+
+void BM_ParseNumeric(benchmark::State &state) {
+  for (auto _ : state) {
+    for (const char *value : VALUES) {
+      NumericValue numeric;
+      benchmark::DoNotOptimize(parse_numeric(value, strlen(value), numeric));
+      benchmark::DoNotOptimize(numeric);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * VALUES.size());
+}
+BENCHMARK(BM_ParseNumeric);
+
+void BM_ParseNumericToFloat(benchmark::State &state) {
+  for (auto _ : state) {
+    for (const char *value : VALUES) {
+      NumericValue numeric;
+      parse_numeric(value, strlen(value), numeric);
+      benchmark::DoNotOptimize(numeric.to_float(3));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * VALUES.size());
+}
+BENCHMARK(BM_ParseNumericToFloat);
+
+}  // namespace
+}  // namespace esphome::efs
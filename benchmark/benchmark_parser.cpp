@@ -0,0 +1,175 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "components/efs/crc16.h"
+#include "components/efs/dlms_parser.h"
+#include "components/efs/parser.h"
+#include "components/efs/result.h"
+#include "test/telegram_corpus.h"
+#include "test/telegram_generator.h"
+
+namespace esphome::efs {
+namespace {
+
+using testing::load_telegram;
+
+// Report the time per object next to the time per telegram
+void set_counters(benchmark::State &state, size_t telegram_size, size_t num_objects) {
+  state.SetBytesProcessed(state.iterations() * telegram_size);
+  state.counters["object"] = benchmark::Counter(
+      static_cast<double>(num_objects), benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+// Count the objects of the telegram, excluding the identification
+size_t count_objects(const std::string &telegram) {
+  std::vector<char> output(telegram.size());
+  Parser parser;
+  parser.begin(output.data(), output.size());
+  parser.feed(telegram.data(), telegram.size());
+  const auto result = parser.finish();
+  size_t num_objects = 0;
+  for (auto it = result.begin(); it != result.end(); ++it) {
+    ++num_objects;
+  }
+  return num_objects == 0 ? 0 : num_objects - 1;
+}
+
+void BM_ParseTelegramInPlace(benchmark::State &state, const char *name) {
+  const auto telegram = load_telegram(name);
+  // Parsing in place overwrites the telegram, the copy is included in the time
+  std::vector<char> buffer(telegram.size());
+  Parser parser;
+  for (auto _ : state) {
+    std::memcpy(buffer.data(), telegram.data(), telegram.size());
+    if (parser.parse_telegram(buffer.data(), buffer.size()).status != Status::OK) {
+      state.SkipWithError("Parsing failed");
+      break;
+    }
+  }
+  set_counters(state, telegram.size(), count_objects(telegram));
+}
+
+// Feed the telegram to a separate output buffer, also reporting the size of the output
+void feed_telegram(benchmark::State &state, const char *name, Encoding encoding) {
+  const auto telegram = load_telegram(name);
+  std::vector<char> output(telegram.size());
+  Parser parser;
+  parser.set_encoding(encoding);
+  size_t output_size = 0;
+  for (auto _ : state) {
+    parser.begin(output.data(), output.size());
+    parser.feed(telegram.data(), telegram.size());
+    const auto result = parser.finish();
+    if (result.status != Status::OK) {
+      state.SkipWithError("Parsing failed");
+      break;
+    }
+    for (const auto &object : result) {
+      output_size = object.data().data() + object.data().size() - output.data();
+    }
+  }
+  set_counters(state, telegram.size(), count_objects(telegram));
+  state.counters["output_bytes"] = static_cast<double>(output_size);
+}
+
+void BM_FeedTelegram(benchmark::State &state, const char *name) { feed_telegram(state, name, Encoding::PADDED); }
+
+void BM_FeedTelegramCompact(benchmark::State &state, const char *name) {
+  feed_telegram(state, name, Encoding::COMPACT);
+}
+
+void BM_Crc16Telegram(benchmark::State &state, const char *name) {
+  const auto telegram = load_telegram(name);
+  for (auto _ : state) {
+    Crc16Calculator calc;
+    calc.update(telegram.data(), telegram.size());
+    benchmark::DoNotOptimize(calc.crc());
+  }
+  state.SetBytesProcessed(state.iterations() * telegram.size());
+}
+
+void iterate_telegram(benchmark::State &state, const char *name, Encoding encoding) {
+  const auto telegram = load_telegram(name);
+  std::vector<char> output(telegram.size());
+  Parser parser;
+  parser.set_encoding(encoding);
+  parser.begin(output.data(), output.size());
+  parser.feed(telegram.data(), telegram.size());
+  const auto result = parser.finish();
+  for (auto _ : state) {
+    size_t value_bytes = 0;
+    for (const auto &object : result) {
+      for (const auto &value : object) {
+        value_bytes += std::get<1>(value);
+      }
+    }
+    benchmark::DoNotOptimize(value_bytes);
+  }
+  set_counters(state, telegram.size(), count_objects(telegram));
+}
+
+void BM_IterateTelegram(benchmark::State &state, const char *name) { iterate_telegram(state, name, Encoding::PADDED); }
+
+// Compact objects have no size field, the object iterator walks the length prefixes to find the next object
+void BM_IterateTelegramCompact(benchmark::State &state, const char *name) {
+  iterate_telegram(state, name, Encoding::COMPACT);
+}
+
+// Parse generated telegrams of increasing size, the time should grow linearly
+void BM_ParseGeneratedTelegram(benchmark::State &state) {
+  const auto telegram = testing::generate_telegram_of_size(state.range(0));
+  std::vector<char> output(telegram.size());
+  Parser parser;
+  for (auto _ : state) {
+    parser.begin(output.data(), output.size());
+    parser.feed(telegram.data(), telegram.size());
+    if (parser.finish().status != Status::OK) {
+      state.SkipWithError("Parsing failed");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * telegram.size());
+  state.SetComplexityN(static_cast<int64_t>(telegram.size()));
+}
+BENCHMARK(BM_ParseGeneratedTelegram)->RangeMultiplier(4)->Range(128, 64 << 10)->Complexity(benchmark::oN);
+
+// Decode the binary DLMS push of the corpus in place, as done for decrypted data notifications
+void BM_ParseDlmsInPlace(benchmark::State &state) {
+  const auto apdu = load_telegram("at_kaifa_dlms.bin");
+  std::vector<char> buffer(apdu.size() * 2);
+  DlmsParser parser;
+  size_t num_objects = 0;
+  for (auto _ : state) {
+    std::memcpy(buffer.data(), apdu.data(), apdu.size());
+    const auto result = parser.parse_in_place(buffer.data(), buffer.size(), apdu.size());
+    if (result.status != Status::OK) {
+      state.SkipWithError("Parsing failed");
+      break;
+    }
+    // Excluding the empty identification
+    num_objects = static_cast<uint8_t>(buffer[1]) - 1;
+  }
+  set_counters(state, apdu.size(), num_objects);
+}
+BENCHMARK(BM_ParseDlmsInPlace);
+
+#define EFS_CORPUS_BENCHMARK(func) \
+  BENCHMARK_CAPTURE(func, dsmr22_iskra, "dsmr22_iskra.txt"); \
+  BENCHMARK_CAPTURE(func, dsmr4_landis, "dsmr4_landis.txt"); \
+  BENCHMARK_CAPTURE(func, dsmr5_kaifa, "dsmr5_kaifa.txt"); \
+  BENCHMARK_CAPTURE(func, be_fluvius, "be_fluvius.txt"); \
+  BENCHMARK_CAPTURE(func, se_aidon, "se_aidon.txt"); \
+  BENCHMARK_CAPTURE(func, lu_smarty, "lu_smarty.txt")
+
+EFS_CORPUS_BENCHMARK(BM_ParseTelegramInPlace);
+EFS_CORPUS_BENCHMARK(BM_FeedTelegram);
+EFS_CORPUS_BENCHMARK(BM_FeedTelegramCompact);
+EFS_CORPUS_BENCHMARK(BM_Crc16Telegram);
+EFS_CORPUS_BENCHMARK(BM_IterateTelegram);
+EFS_CORPUS_BENCHMARK(BM_IterateTelegramCompact);
+
+}  // namespace
+}  // namespace esphome::efs
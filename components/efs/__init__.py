@@ -1,5 +1,6 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
+import esphome.final_validate as fv
 from esphome import pins
 from esphome.components import uart
 from esphome.const import (
@@ -7,23 +8,40 @@ from esphome.const import (
     CONF_UART_ID,
     CONF_RECEIVE_TIMEOUT,
 )
+from esphome.core import CORE, ID
 
 CODEOWNERS = ["@erikced"]
 
+DOMAIN = "efs"
+
 MULTI_CONF = True
 
 DEPENDENCIES = ["uart"]
 AUTO_LOAD = ["sensor", "text_sensor"]
 
+CONF_AUTHENTICATION_KEY = "authentication_key"
+CONF_CRC_TABLES = "crc_tables"
+CONF_COMPACT_OUTPUT = "compact_output"
+CONF_CRYPTO_BACKEND = "crypto_backend"
 CONF_DECRYPTION_KEY = "decryption_key"
+CONF_DOUBLE_BUFFER = "double_buffer"
 CONF_EFS_ID = "efs_id"
+CONF_HDLC = "hdlc"
+CONF_LOOP_BUDGET = "loop_budget"
+CONF_MAX_SENSORS = "max_sensors"
 CONF_MAX_TELEGRAM_LENGTH = "max_telegram_length"
 CONF_PRINT_VALUES = "print_values"
 CONF_REQUEST_INTERVAL = "request_interval"
 CONF_REQUEST_PIN = "request_pin"
+CONF_STATIC_ALLOCATION = "static_allocation"
+CONF_TELEGRAM_POOL = "telegram_pool"
 
 efs_ns = cg.esphome_ns.namespace("efs")
 Efs = efs_ns.class_("Efs", cg.Component, uart.UARTDevice)
+TelegramPool = efs_ns.class_("TelegramPool")
+
+# All meters with a telegram pool share the same one
+TELEGRAM_POOL_ID = "efs_telegram_pool"
 
 
 def _validate_key(value):
@@ -44,11 +62,60 @@ def _validate_key(value):
     return "".join(f"{part:02X}" for part in parts_int)
 
 
+def _validate_crypto_backend(config):
+    # mbedTLS is part of the ESP32 frameworks, where it uses the hardware AES accelerator
+    backend = config.get(CONF_CRYPTO_BACKEND)
+    if backend is None:
+        config[CONF_CRYPTO_BACKEND] = "mbedtls" if CORE.is_esp32 else "software"
+    elif backend == "mbedtls" and not CORE.is_esp32:
+        raise cv.Invalid("The mbedtls crypto backend is only available on the ESP32")
+    elif backend == "software" and not CORE.using_arduino:
+        raise cv.Invalid("The software crypto backend requires the Arduino framework")
+    return config
+
+
+def _validate_telegram_pool(config):
+    if CONF_TELEGRAM_POOL not in config:
+        return config
+    for option in (CONF_DOUBLE_BUFFER, CONF_HDLC, CONF_STATIC_ALLOCATION):
+        if config[option]:
+            raise cv.Invalid(f"{CONF_TELEGRAM_POOL} can not be used with {option}")
+    return config
+
+
+def _final_validate_static_allocation(config):
+    # The capacities are compile time defines shared by all meters, so every meter must ask for the same ones
+    meters = fv.full_config.get()[DOMAIN]
+    if not any(meter[CONF_STATIC_ALLOCATION] for meter in meters):
+        return config
+    for option in (
+        CONF_STATIC_ALLOCATION,
+        CONF_MAX_TELEGRAM_LENGTH,
+        CONF_DOUBLE_BUFFER,
+        CONF_MAX_SENSORS,
+    ):
+        if any(meter[option] != config[option] for meter in meters):
+            raise cv.Invalid(
+                f"All meters must have the same {option} when one of them uses {CONF_STATIC_ALLOCATION}"
+            )
+    return config
+
+
+def _final_validate_crypto_backend(config):
+    # The backend is a compile time define shared by all meters
+    meters = fv.full_config.get()[DOMAIN]
+    if any(meter[CONF_CRYPTO_BACKEND] != config[CONF_CRYPTO_BACKEND] for meter in meters):
+        raise cv.Invalid(f"All meters must have the same {CONF_CRYPTO_BACKEND}")
+    return config
+
+
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(Efs),
             cv.Optional(CONF_DECRYPTION_KEY): _validate_key,
+            cv.Optional(CONF_AUTHENTICATION_KEY): _validate_key,
+            cv.Optional(CONF_CRYPTO_BACKEND): cv.one_of("mbedtls", "software", lower=True),
             cv.Optional(CONF_MAX_TELEGRAM_LENGTH, default=1500): cv.int_,
             cv.Optional(CONF_REQUEST_PIN): pins.gpio_output_pin_schema,
             cv.Optional(
@@ -57,21 +124,54 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(
                 CONF_RECEIVE_TIMEOUT, default="200ms"
             ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_LOOP_BUDGET, default="10ms"
+            ): cv.positive_time_period_microseconds,
+            cv.Optional(CONF_DOUBLE_BUFFER, default=False): cv.boolean,
+            cv.Optional(CONF_HDLC, default=False): cv.boolean,
+            cv.Optional(CONF_COMPACT_OUTPUT, default=False): cv.boolean,
+            cv.Optional(CONF_STATIC_ALLOCATION, default=False): cv.boolean,
+            cv.Optional(CONF_MAX_SENSORS, default=32): cv.int_range(min=1, max=255),
+            cv.Optional(CONF_TELEGRAM_POOL): cv.int_range(min=1, max=8),
             cv.Optional(CONF_PRINT_VALUES, default=False): cv.boolean,
+            cv.Optional(CONF_CRC_TABLES, default=4): cv.one_of(1, 2, 4, 8, int=True),
         }
     ).extend(uart.UART_DEVICE_SCHEMA),
-    cv.only_with_arduino,
+    _validate_crypto_backend,
+    _validate_telegram_pool,
 )
 
+FINAL_VALIDATE_SCHEMA = cv.All(_final_validate_static_allocation, _final_validate_crypto_backend)
+
 
 async def to_code(config):
     uart_component = await cg.get_variable(config[CONF_UART_ID])
     var = cg.new_Pvariable(config[CONF_ID], uart_component)
     if config[CONF_PRINT_VALUES]:
         cg.add_define("EFS_PRINT_VALUES")
+    cg.add_define("EFS_CRC16_SLICES", config[CONF_CRC_TABLES])
     cg.add(var.set_max_telegram_length(config[CONF_MAX_TELEGRAM_LENGTH]))
+    if config[CONF_STATIC_ALLOCATION]:
+        # Buffers and the sensor table are sized at compile time and not allocated from the heap
+        cg.add_define("EFS_STATIC_ALLOCATION")
+        cg.add_define("EFS_MAX_TELEGRAM_LENGTH", config[CONF_MAX_TELEGRAM_LENGTH])
+        cg.add_define("EFS_MAX_SENSORS", config[CONF_MAX_SENSORS])
+        cg.add_define("EFS_TELEGRAM_BUFFERS", 2 if config[CONF_DOUBLE_BUFFER] else 1)
+    cg.add(var.set_double_buffer(config[CONF_DOUBLE_BUFFER]))
+    cg.add(var.set_hdlc(config[CONF_HDLC]))
+    cg.add(var.set_compact_output(config[CONF_COMPACT_OUTPUT]))
+    if CONF_TELEGRAM_POOL in config:
+        # Declared by the first meter, the pool has as many buffers as the largest telegram_pool option asks for
+        if TELEGRAM_POOL_ID not in CORE.data:
+            pool_id = ID(TELEGRAM_POOL_ID, is_declaration=True, type=TelegramPool)
+            CORE.data[TELEGRAM_POOL_ID] = cg.new_Pvariable(pool_id)
+        pool = CORE.data[TELEGRAM_POOL_ID]
+        cg.add(pool.require_buffers(config[CONF_TELEGRAM_POOL]))
+        cg.add(var.set_telegram_pool(pool))
     if CONF_DECRYPTION_KEY in config:
         cg.add(var.set_decryption_key(config[CONF_DECRYPTION_KEY]))
+    if CONF_AUTHENTICATION_KEY in config:
+        cg.add(var.set_authentication_key(config[CONF_AUTHENTICATION_KEY]))
     await cg.register_component(var, config)
 
     if CONF_REQUEST_PIN in config:
@@ -79,6 +179,11 @@ async def to_code(config):
         cg.add(var.set_request_pin(request_pin))
     cg.add(var.set_request_interval(config[CONF_REQUEST_INTERVAL].total_milliseconds))
     cg.add(var.set_receive_timeout(config[CONF_RECEIVE_TIMEOUT].total_milliseconds))
+    cg.add(var.set_loop_budget(config[CONF_LOOP_BUDGET].total_microseconds))
 
     # Crypto
-    cg.add_library("rweather/Crypto", "0.4.0")
+    if config[CONF_CRYPTO_BACKEND] == "mbedtls":
+        cg.add_define("EFS_GCM_MBEDTLS")
+    else:
+        cg.add_define("EFS_GCM_SOFTWARE")
+        cg.add_library("rweather/Crypto", "0.4.0")
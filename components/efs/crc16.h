@@ -1,12 +1,22 @@
 #pragma once
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
+// Number of lookup tables used by the bulk CRC-16 update. Each table occupies
+// 512 bytes, more tables process more bytes per iteration.
+#ifndef EFS_CRC16_SLICES
+#define EFS_CRC16_SLICES 4
+#endif
+
 namespace esphome {
 namespace efs {
 namespace util {
-constexpr std::array<uint16_t, 256> init_table() {
-  const uint16_t polynomial = 0xA001;
+/// Polynomials of the reflected CRC-16 variants, CRC-16/ARC used by P1 telegrams and the FCS-16 of HDLC frames.
+constexpr uint16_t CRC16_ARC_POLYNOMIAL = 0xA001;
+constexpr uint16_t FCS16_POLYNOMIAL = 0x8408;
+
+constexpr std::array<uint16_t, 256> init_table(uint16_t polynomial) {
   std::array<uint16_t, 256> table = {0};
   uint16_t counter = 0;
   for (auto &table_value : table) {
@@ -25,22 +35,62 @@ constexpr std::array<uint16_t, 256> init_table() {
   }
   return table;
 }
+
+// Table n holds the CRC of each byte value followed by n zero bytes.
+template<size_t Slices, uint16_t Polynomial>
+constexpr std::array<std::array<uint16_t, 256>, Slices> init_slice_tables() {
+  std::array<std::array<uint16_t, 256>, Slices> tables = {init_table(Polynomial)};
+  for (size_t slice = 1; slice < Slices; ++slice) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint16_t previous = tables[slice - 1][i];
+      tables[slice][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+    }
+  }
+  return tables;
+}
 }  // namespace util
 
-class Crc16Calculator {
+template<size_t Slices, uint16_t Polynomial = util::CRC16_ARC_POLYNOMIAL, uint16_t Init = 0>
+class BaseCrc16Calculator {
+  static_assert(Slices == 1 || Slices == 2 || Slices == 4 || Slices == 8, "Slices must be 1, 2, 4 or 8.");
+
  public:
   void update(const char &ch) {
     const auto index = static_cast<uint8_t>(crc_ ^ static_cast<uint8_t>(ch));
-    crc_ = (crc_ >> 8) ^ TABLE[index];
+    crc_ = (crc_ >> 8) ^ TABLES[0][index];
   };
 
+  void update(const char *data, size_t size) {
+    const auto *pos = reinterpret_cast<const uint8_t *>(data);
+    if constexpr (Slices > 1) {
+      for (; size >= Slices; size -= Slices, pos += Slices) {
+        uint16_t crc = TABLES[Slices - 1][static_cast<uint8_t>(crc_ ^ pos[0])] ^
+                       TABLES[Slices - 2][static_cast<uint8_t>((crc_ >> 8) ^ pos[1])];
+        for (size_t i = 2; i < Slices; ++i) {
+          crc ^= TABLES[Slices - 1 - i][pos[i]];
+        }
+        crc_ = crc;
+      }
+    }
+    for (; size > 0; --size, ++pos) {
+      crc_ = (crc_ >> 8) ^ TABLES[0][static_cast<uint8_t>(crc_ ^ *pos)];
+    }
+  }
+
   uint16_t crc() { return crc_; };
-  void reset() { crc_ = 0; };
+  void reset() { crc_ = Init; };
 
  protected:
-  uint16_t crc_ = 0;
-  static constexpr auto TABLE = util::init_table();
+  uint16_t crc_ = Init;
+  static constexpr auto TABLES = util::init_slice_tables<Slices, Polynomial>();
 };
 
+using Crc16Calculator = BaseCrc16Calculator<EFS_CRC16_SLICES>;
+
+/// FCS-16 of HDLC frames (CRC-16/X.25). The frame check sequence is sent complemented and least significant byte
+/// first, so the register holds FCS16_GOOD after the check sequence of a valid frame has been added.
+using Fcs16Calculator = BaseCrc16Calculator<EFS_CRC16_SLICES, util::FCS16_POLYNOMIAL, 0xFFFF>;
+constexpr uint16_t FCS16_GOOD = 0xF0B8;
+
 }  // namespace efs
 }  // namespace esphome
@@ -0,0 +1,632 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "header.h"
+#include "numeric_value.h"
+#include "obis_code.h"
+#include "parser.h"
+#include "result.h"
+#include "status.h"
+
+namespace esphome {
+namespace efs {
+namespace dlms {
+/// A-XDR data type tags.
+enum Tag : uint8_t {
+  NULL_DATA = 0x00,
+  ARRAY = 0x01,
+  STRUCTURE = 0x02,
+  BOOLEAN = 0x03,
+  BIT_STRING = 0x04,
+  DOUBLE_LONG = 0x05,
+  DOUBLE_LONG_UNSIGNED = 0x06,
+  OCTET_STRING = 0x09,
+  VISIBLE_STRING = 0x0A,
+  UTF8_STRING = 0x0C,
+  BCD = 0x0D,
+  INTEGER = 0x0F,
+  LONG = 0x10,
+  UNSIGNED = 0x11,
+  LONG_UNSIGNED = 0x12,
+  LONG64 = 0x14,
+  LONG64_UNSIGNED = 0x15,
+  ENUM = 0x16,
+  FLOAT32 = 0x17,
+  FLOAT64 = 0x18,
+  DATE_TIME = 0x19,
+  DATE = 0x1A,
+  TIME = 0x1B,
+};
+
+/// Tag of the data-notification APDU pushed by meters.
+const uint8_t DATA_NOTIFICATION = 0x0F;
+const size_t DATE_TIME_SIZE = 12;
+const size_t OBIS_CODE_SIZE = 6;
+const uint8_t MAX_DEPTH = 8;
+
+/// Tag of the general-glo-ciphering APDU that encrypted data are wrapped in.
+const uint8_t GENERAL_GLO_CIPHERING = 0xDB;
+const size_t SYSTEM_TITLE_SIZE = 8;
+const size_t FRAME_COUNTER_SIZE = 4;
+const size_t AUTHENTICATION_TAG_SIZE = 12;
+/// Bits of the security control byte.
+const uint8_t SECURITY_AUTHENTICATED = 0x10;
+const uint8_t SECURITY_ENCRYPTED = 0x20;
+
+/// The parts of a general-glo-ciphering APDU, pointing into the APDU.
+struct CipheredApdu {
+  const uint8_t *system_title;
+  uint8_t security_control;
+  const uint8_t *frame_counter;
+  uint8_t *ciphertext;
+  size_t ciphertext_size;
+  /// nullptr if the APDU is not authenticated.
+  const uint8_t *tag;
+};
+
+/// Split a general-glo-ciphering APDU of size bytes into its parts, returns false if it is malformed.
+inline bool split_ciphered_apdu(uint8_t *apdu, size_t size, CipheredApdu &parts) {
+  // Tag, system title length and system title, followed by the length of the rest
+  size_t pos = 2 + SYSTEM_TITLE_SIZE;
+  if (size <= pos || apdu[0] != GENERAL_GLO_CIPHERING || apdu[1] != SYSTEM_TITLE_SIZE) {
+    return false;
+  }
+  size_t length = apdu[pos++];
+  if ((length & 0x80) != 0) {
+    const size_t length_size = length & 0x7F;
+    if (length_size == 0 || length_size > 2 || size < pos + length_size) {
+      return false;
+    }
+    length = 0;
+    for (size_t i = 0; i < length_size; ++i) {
+      length = (length << 8) | apdu[pos++];
+    }
+  }
+  if (length != size - pos || length < 1 + FRAME_COUNTER_SIZE) {
+    return false;
+  }
+  parts.system_title = &apdu[2];
+  parts.security_control = apdu[pos];
+  parts.frame_counter = &apdu[pos + 1];
+  const size_t tag_size = (parts.security_control & SECURITY_AUTHENTICATED) != 0 ? AUTHENTICATION_TAG_SIZE : 0;
+  if (length < 1 + FRAME_COUNTER_SIZE + tag_size) {
+    return false;
+  }
+  parts.ciphertext = &apdu[pos + 1 + FRAME_COUNTER_SIZE];
+  parts.ciphertext_size = length - 1 - FRAME_COUNTER_SIZE - tag_size;
+  parts.tag = tag_size > 0 ? &apdu[size - tag_size] : nullptr;
+  return true;
+}
+
+/// Convert a DLMS unit enumeration value to a unit, only the units that appear in telegrams are supported.
+constexpr Unit to_unit(uint8_t unit) {
+  switch (unit) {
+    case 7:
+      return Unit::S;
+    case 13:
+    case 14:
+      return Unit::M3;
+    case 27:
+      return Unit::W;
+    case 28:
+      return Unit::VA;
+    case 29:
+      return Unit::VAR;
+    case 30:
+      return Unit::WH;
+    case 31:
+      return Unit::VAH;
+    case 32:
+      return Unit::VARH;
+    case 33:
+      return Unit::A;
+    case 35:
+      return Unit::V;
+    case 44:
+      return Unit::HZ;
+    case 255:
+      return Unit::NONE;
+    default:
+      return Unit::UNKNOWN;
+  }
+}
+}  // namespace dlms
+
+/// Parser for DLMS/COSEM data-notification APDUs, encoded with A-XDR.
+///
+/// The output has the same format as the output of BaseParser, so that it
+/// is read through the same Result. Each octet string of 6 bytes is taken as
+/// an OBIS code and the value that follows it as the value of the object. A
+/// structure of a scaler and a unit directly after the value is applied to
+/// it. The values are written as text as they would appear in a P1
+/// telegram, e.g. "1234.567*kWh", with energy and power converted to their
+/// kilo units. Values without an OBIS code are not output.
+class DlmsParser {
+ public:
+  /// Only output the objects whose OBIS codes are in the array codes, sorted in ascending order, see
+  /// BaseParser::set_filter().
+  void set_filter(const ObisCode *codes, size_t num_codes) {
+    assert(codes == nullptr || std::is_sorted(codes, codes + num_codes));
+    filter_ = codes;
+    filter_end_ = codes == nullptr ? nullptr : &codes[num_codes];
+  }
+
+  /// Append a sorted index of the objects to the output, see BaseParser::set_index().
+  void set_index(bool enabled) { index_enabled_ = enabled; }
+
+  /// Parse the APDU in apdu, writing the parsed output to buffer.
+  Result parse(const uint8_t *apdu, size_t apdu_size, char *buffer, size_t buffer_size) {
+    begin_(apdu, apdu_size, buffer, buffer_size);
+    in_place_ = false;
+    return parse_();
+  }
+
+  /// Parse an APDU of apdu_size bytes at the start of buffer in place.
+  ///
+  /// The APDU is first moved to the end of the buffer, after which the output
+  /// overwrites it as it is read. Numeric values usually take less room as text
+  /// than encoded, but binary octet strings are written as hex and need twice
+  /// their size, so leave some room after the APDU.
+  Result parse_in_place(char *buffer, size_t buffer_size, size_t apdu_size) {
+    apdu_size = std::min(apdu_size, buffer_size);
+    char *const apdu = &buffer[buffer_size - apdu_size];
+    std::memmove(apdu, buffer, apdu_size);
+    begin_(reinterpret_cast<const uint8_t *>(apdu), apdu_size, buffer, buffer_size);
+    in_place_ = true;
+    return parse_();
+  }
+
+ protected:
+  /// A decoded value which is waiting for a possible scaler and unit.
+  struct Value {
+    enum class Kind : uint8_t { SIGNED, UNSIGNED, STRING, DATE_TIME };
+    Kind kind;
+    int64_t signed_value;
+    uint64_t unsigned_value;
+    const uint8_t *data;
+    size_t size;
+  };
+
+  void begin_(const uint8_t *apdu, size_t apdu_size, char *buffer, size_t buffer_size) {
+    read_pos_ = apdu;
+    read_end_ = &apdu[apdu_size];
+    buffer_ = write_pos_ = buffer;
+    buffer_end_ = &buffer[buffer_size];
+    status_ = Status::OK;
+    num_objects_ = nullptr;
+    has_obis_code_ = false;
+    has_value_ = false;
+  }
+
+  Result parse_() {
+    if (reinterpret_cast<uintptr_t>(buffer_) % 2 != 0) {
+      return Result(Status::BUFFER_NOT_ALIGNED, nullptr, 0);
+    }
+    const uint8_t *tag = read_(1);
+    if (tag == nullptr || *tag != dlms::DATA_NOTIFICATION) {
+      return Result(Status::START_NOT_FOUND, nullptr, 0);
+    }
+    // Long invoke id and priority, followed by an optional date-time octet string without a tag
+    const uint8_t *date_time_size = read_(4) != nullptr ? read_(1) : nullptr;
+    if (date_time_size == nullptr || (*date_time_size != 0 && read_(*date_time_size) == nullptr)) {
+      return Result(Status::PARSING_FAILED, nullptr, 0);
+    }
+    // Empty identification, as a binary push has none, followed by the number of objects
+    num_objects_ = reinterpret_cast<uint8_t *>(&buffer_[1]);
+    write_("\0", 2, write_end_());
+    if (status_ != Status::OK) {
+      return Result(status_, nullptr, 0);
+    }
+    *num_objects_ = 0;
+
+    parse_element_(0);
+    end_object_();
+    const size_t size = write_pos_ - buffer_;
+    if (status_ == Status::OK && index_enabled_) {
+      const size_t index_size = *num_objects_ * INDEX_ENTRY_SIZE;
+      if (static_cast<size_t>(write_end_() - write_pos_) >= index_size && size / 2 <= UINT16_MAX) {
+        auto *const index = reinterpret_cast<IndexEntry *>(write_pos_);
+        util::write_index(buffer_, &buffer_[2], *num_objects_, index);
+        return Result(status_, buffer_, size, index, *num_objects_);
+      }
+    }
+    return Result(status_, buffer_, size);
+  }
+
+  const uint8_t *read_(size_t size) {
+    if (static_cast<size_t>(read_end_ - read_pos_) < size) {
+      status_ = Status::PARSING_FAILED;
+      return nullptr;
+    }
+    const uint8_t *data = read_pos_;
+    read_pos_ += size;
+    return data;
+  }
+
+  bool read_length_(size_t &length) {
+    const uint8_t *first = read_(1);
+    if (first == nullptr) {
+      return false;
+    }
+    if ((*first & 0x80) == 0) {
+      length = *first;
+      return true;
+    }
+    const uint8_t num_bytes = *first & 0x7F;
+    const uint8_t *bytes = num_bytes <= sizeof(uint32_t) ? read_(num_bytes) : nullptr;
+    if (bytes == nullptr) {
+      status_ = Status::PARSING_FAILED;
+      return false;
+    }
+    length = 0;
+    for (uint8_t i = 0; i < num_bytes; ++i) {
+      length = length << 8 | bytes[i];
+    }
+    return true;
+  }
+
+  template<typename T> bool read_integer_(T &value) {
+    const uint8_t *bytes = read_(sizeof(T));
+    if (bytes == nullptr) {
+      return false;
+    }
+    // A-XDR integers are big endian
+    uint64_t raw = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      raw = raw << 8 | bytes[i];
+    }
+    value = static_cast<T>(raw);
+    return true;
+  }
+
+  void parse_element_(uint8_t depth) {
+    const uint8_t *tag = read_(1);
+    if (tag == nullptr) {
+      return;
+    }
+    Value value{Value::Kind::SIGNED, 0, 0, nullptr, 0};
+    switch (*tag) {
+      case dlms::ARRAY:
+      case dlms::STRUCTURE: {
+        size_t length;
+        if (!read_length_(length)) {
+          return;
+        }
+        if (*tag == dlms::STRUCTURE && length == 2 && read_scaler_unit_()) {
+          return;
+        }
+        end_object_();
+        if (depth == dlms::MAX_DEPTH) {
+          status_ = Status::PARSING_FAILED;
+          return;
+        }
+        for (size_t i = 0; i < length && status_ == Status::OK; ++i) {
+          parse_element_(depth + 1);
+        }
+        // The last value of a structure is not followed by a scaler and unit
+        end_object_();
+        return;
+      }
+      case dlms::OCTET_STRING:
+      case dlms::VISIBLE_STRING:
+      case dlms::UTF8_STRING:
+        if (!read_length_(value.size) || (value.data = read_(value.size)) == nullptr) {
+          return;
+        }
+        value.kind = *tag == dlms::OCTET_STRING && value.size == dlms::DATE_TIME_SIZE ? Value::Kind::DATE_TIME
+                                                                                        : Value::Kind::STRING;
+        if (*tag == dlms::OCTET_STRING && value.size == dlms::OBIS_CODE_SIZE && !(has_obis_code_ && !has_value_)) {
+          // Copied first, since writing the previous object may overwrite it when parsing in place
+          uint8_t obis_code[dlms::OBIS_CODE_SIZE];
+          std::memcpy(obis_code, value.data, sizeof(obis_code));
+          end_object_();
+          start_object_(obis_code);
+          return;
+        }
+        break;
+      case dlms::BIT_STRING: {
+        size_t num_bits;
+        if (!read_length_(num_bits) || (value.data = read_((num_bits + 7) / 8)) == nullptr) {
+          return;
+        }
+        value.kind = Value::Kind::STRING;
+        value.size = (num_bits + 7) / 8;
+        break;
+      }
+      case dlms::DATE_TIME:
+        value.kind = Value::Kind::DATE_TIME;
+        value.size = dlms::DATE_TIME_SIZE;
+        if ((value.data = read_(value.size)) == nullptr) {
+          return;
+        }
+        break;
+      case dlms::DATE:
+      case dlms::TIME:
+        value.kind = Value::Kind::STRING;
+        value.size = *tag == dlms::DATE ? 5 : 4;
+        if ((value.data = read_(value.size)) == nullptr) {
+          return;
+        }
+        break;
+      case dlms::NULL_DATA:
+        end_object_();
+        return;
+      case dlms::BOOLEAN:
+      case dlms::UNSIGNED:
+      case dlms::ENUM:
+      case dlms::BCD: {
+        uint8_t raw;
+        value.kind = Value::Kind::UNSIGNED;
+        if (!read_integer_(raw)) {
+          return;
+        }
+        value.unsigned_value = raw;
+        break;
+      }
+      case dlms::LONG_UNSIGNED: {
+        uint16_t raw;
+        value.kind = Value::Kind::UNSIGNED;
+        if (!read_integer_(raw)) {
+          return;
+        }
+        value.unsigned_value = raw;
+        break;
+      }
+      case dlms::DOUBLE_LONG_UNSIGNED: {
+        uint32_t raw;
+        value.kind = Value::Kind::UNSIGNED;
+        if (!read_integer_(raw)) {
+          return;
+        }
+        value.unsigned_value = raw;
+        break;
+      }
+      case dlms::LONG64_UNSIGNED:
+        value.kind = Value::Kind::UNSIGNED;
+        if (!read_integer_(value.unsigned_value)) {
+          return;
+        }
+        break;
+      case dlms::INTEGER: {
+        int8_t raw;
+        if (!read_integer_(raw)) {
+          return;
+        }
+        value.signed_value = raw;
+        break;
+      }
+      case dlms::LONG: {
+        int16_t raw;
+        if (!read_integer_(raw)) {
+          return;
+        }
+        value.signed_value = raw;
+        break;
+      }
+      case dlms::DOUBLE_LONG: {
+        int32_t raw;
+        if (!read_integer_(raw)) {
+          return;
+        }
+        value.signed_value = raw;
+        break;
+      }
+      case dlms::LONG64:
+        if (!read_integer_(value.signed_value)) {
+          return;
+        }
+        break;
+      default:
+        // Floating point values are not used by meters and have no exact decimal representation
+        status_ = Status::PARSING_FAILED;
+        return;
+    }
+    if (has_obis_code_ && !has_value_) {
+      value_ = value;
+      has_value_ = true;
+    } else {
+      end_object_();
+    }
+  }
+
+  // Read a structure of an integer scaler and an enum unit, if there is one and a value is waiting for it.
+  bool read_scaler_unit_() {
+    if (!has_value_ || read_end_ - read_pos_ < 4 || read_pos_[0] != dlms::INTEGER || read_pos_[2] != dlms::ENUM) {
+      return false;
+    }
+    scaler_ = static_cast<int8_t>(read_pos_[1]);
+    unit_ = dlms::to_unit(read_pos_[3]);
+    read_pos_ += 4;
+    end_object_();
+    return true;
+  }
+
+  void start_object_(const uint8_t *obis_code) {
+    // Only 5 parts are stored, the 6th part is usually 255
+    obis_code_ = ObisCode(obis_code[0], obis_code[1], obis_code[2], obis_code[3], obis_code[4]);
+    has_obis_code_ = true;
+    has_value_ = false;
+    scaler_ = 0;
+    unit_ = Unit::NONE;
+  }
+
+  // Write the object whose OBIS code and value have been read.
+  void end_object_() {
+    const bool complete = has_obis_code_ && has_value_;
+    has_obis_code_ = has_value_ = false;
+    if (!complete || status_ != Status::OK) {
+      return;
+    }
+    if (filter_ != nullptr && !std::binary_search(filter_, filter_end_, obis_code_)) {
+      return;
+    }
+    if (*num_objects_ == MAX_NUM_OBJECTS) {
+      status_ = Status::TOO_MANY_OBJECTS;
+      return;
+    }
+    auto *const header = reinterpret_cast<Header *>(write_pos_);
+    Header value{{}, 1, 0};
+    obis_code_.to_bytes(value.obis_code);
+    // The header must not overwrite a string or date-time value which is still in the APDU when parsing in place
+    const char *const header_end =
+        in_place_ && value_.data != nullptr ? reinterpret_cast<const char *>(value_.data) : write_end_();
+    if (!write_(reinterpret_cast<const char *>(&value), HEADER_SIZE, header_end)) {
+      return;
+    }
+    write_value_();
+    write_("", 1, write_end_());
+    if ((write_pos_ - reinterpret_cast<char *>(header)) % 2 != 0) {
+      write_("", 1, write_end_());
+    }
+    if (status_ != Status::OK) {
+      return;
+    }
+    header->object_size = static_cast<uint16_t>(write_pos_ - reinterpret_cast<char *>(header));
+    ++(*num_objects_);
+  }
+
+  void write_value_() {
+    char text[48];
+    size_t size = 0;
+    switch (value_.kind) {
+      case Value::Kind::SIGNED:
+      case Value::Kind::UNSIGNED: {
+        const bool is_signed = value_.kind == Value::Kind::SIGNED;
+        if (!is_signed && value_.unsigned_value > static_cast<uint64_t>(INT64_MAX)) {
+          // Too large for a NumericValue, written without scaler and unit
+          size = write_digits_(text, value_.unsigned_value, 0);
+          break;
+        }
+        const int64_t mantissa = is_signed ? value_.signed_value : static_cast<int64_t>(value_.unsigned_value);
+        const auto number = NumericValue{mantissa, scaler_, unit_}.normalized();
+        size = write_number_(text, number);
+        break;
+      }
+      case Value::Kind::DATE_TIME:
+        size = write_date_time_(text, value_.data);
+        break;
+      case Value::Kind::STRING:
+        write_string_();
+        return;
+    }
+    write_(text, size, write_end_());
+  }
+
+  // Write a string as is if it is printable and otherwise as hex.
+  void write_string_() {
+    const bool printable =
+        std::all_of(value_.data, &value_.data[value_.size], [](uint8_t ch) { return ch >= 0x20 && ch < 0x7F; });
+    if (printable) {
+      // The output never passes the string when parsing in place, since it is written before it
+      write_(reinterpret_cast<const char *>(value_.data), value_.size, write_end_());
+      return;
+    }
+    const char *const digits = "0123456789ABCDEF";
+    for (size_t i = 0; i < value_.size && status_ == Status::OK; ++i) {
+      const uint8_t byte = value_.data[i];
+      const char hex[2] = {digits[byte >> 4], digits[byte & 0x0F]};
+      // Bytes of the string which have not been written yet must not be overwritten
+      const char *const write_end = in_place_ ? reinterpret_cast<const char *>(&value_.data[i + 1]) : buffer_end_;
+      write_(hex, sizeof(hex), std::min(write_end, write_end_()));
+    }
+  }
+
+  static size_t write_digits_(char *text, uint64_t value, size_t min_digits) {
+    char digits[24];
+    size_t num_digits = 0;
+    do {
+      digits[num_digits++] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value != 0 || num_digits < min_digits);
+    std::reverse_copy(digits, &digits[num_digits], text);
+    return num_digits;
+  }
+
+  // Write a number as text, e.g. "-12.345*kWh".
+  static size_t write_number_(char *text, const NumericValue &number) {
+    size_t size = 0;
+    if (number.mantissa < 0) {
+      text[size++] = '-';
+    }
+    const uint64_t magnitude =
+        number.mantissa < 0 ? ~static_cast<uint64_t>(number.mantissa) + 1 : static_cast<uint64_t>(number.mantissa);
+    if (number.scale >= 0) {
+      size += write_digits_(&text[size], magnitude, 1);
+      // A positive scale is written as trailing zeros, values with too many digits are not decoded
+      for (int8_t i = 0; i < std::min<int8_t>(number.scale, 18); ++i) {
+        text[size++] = '0';
+      }
+    } else {
+      const size_t num_decimals = std::min<size_t>(-number.scale, 18);
+      const size_t num_digits = write_digits_(&text[size], magnitude, num_decimals + 1);
+      // Insert the decimal point before the decimals
+      std::memmove(&text[size + num_digits - num_decimals + 1], &text[size + num_digits - num_decimals], num_decimals);
+      text[size + num_digits - num_decimals] = '.';
+      size += num_digits + 1;
+    }
+    const char *unit = util::unit_name(number.unit);
+    if (unit != nullptr) {
+      text[size++] = '*';
+      for (; *unit != '\0'; ++unit) {
+        text[size++] = *unit;
+      }
+    }
+    return size;
+  }
+
+  // Write a COSEM date-time as a P1 timestamp, e.g. "101209113020W".
+  static size_t write_date_time_(char *text, const uint8_t *date_time) {
+    const uint16_t year = date_time[0] << 8 | date_time[1];
+    const uint8_t parts[] = {static_cast<uint8_t>(year % 100), date_time[2], date_time[3],
+                             date_time[5],                     date_time[6], date_time[7]};
+    size_t size = 0;
+    for (const uint8_t part : parts) {
+      size += write_digits_(&text[size], part % 100, 2);
+    }
+    // Bit 7 of the clock status is set during daylight saving time
+    text[size++] = (date_time[11] & 0x80) != 0 ? 'S' : 'W';
+    return size;
+  }
+
+  // Output may not overwrite APDU bytes which have not been read when parsing in place.
+  const char *write_end_() const { return in_place_ ? reinterpret_cast<const char *>(read_pos_) : buffer_end_; }
+
+  bool write_(const char *data, size_t size, const char *write_end) {
+    if (status_ != Status::OK) {
+      return false;
+    }
+    if (write_end - write_pos_ < static_cast<ptrdiff_t>(size)) {
+      status_ = Status::WRITE_OVERFLOW;
+      return false;
+    }
+    std::memmove(write_pos_, data, size);
+    write_pos_ += size;
+    return true;
+  }
+
+ private:
+  const uint8_t *read_pos_ = nullptr;
+  const uint8_t *read_end_ = nullptr;
+  char *buffer_ = nullptr;
+  char *buffer_end_ = nullptr;
+  char *write_pos_ = nullptr;
+  bool in_place_ = false;
+  bool index_enabled_ = false;
+  Status status_ = Status::OK;
+  uint8_t *num_objects_ = nullptr;
+  const ObisCode *filter_ = nullptr;
+  const ObisCode *filter_end_ = nullptr;
+  ObisCode obis_code_{0, 0, 0, 0, 0};
+  bool has_obis_code_ = false;
+  bool has_value_ = false;
+  Value value_{};
+  int8_t scaler_ = 0;
+  Unit unit_ = Unit::NONE;
+};
+
+}  // namespace efs
+}  // namespace esphome
@@ -1,13 +1,11 @@
-#ifdef USE_ARDUINO
+#if defined(USE_ARDUINO) || defined(USE_ESP_IDF)
 
 #include "efs.h"
 #include "esphome/core/log.h"
 
+#include <cinttypes>
 #include <stdlib.h>
-
-#include <AES.h>
-#include <Crypto.h>
-#include <GCM.h>
+#include <utility>
 
 namespace esphome {
 namespace efs {
@@ -15,20 +13,55 @@ namespace efs {
 static const char *const TAG = "efs";
 
 void Efs::setup() {
-  this->telegram_ = new char[this->max_telegram_len_];  // NOLINT
+#ifdef EFS_STATIC_ALLOCATION
+  this->max_telegram_len_ = MAX_TELEGRAM_LENGTH;
+  this->telegram_ = this->telegram_storage_[0];
+#if EFS_TELEGRAM_BUFFERS > 1
+  this->spare_telegram_ = this->telegram_storage_[1];
+#endif
+#else
+  if (this->telegram_pool_ != nullptr) {
+    // The buffer is borrowed for each telegram, the first meter to be set up allocates the shared buffers
+    this->telegram_pool_->allocate();
+  } else {
+    this->telegram_ = new char[this->max_telegram_len_];  // NOLINT
+    if (this->double_buffer_) {
+      this->spare_telegram_ = new char[this->max_telegram_len_];  // NOLINT
+    }
+  }
+#endif
+  if (this->telegram_ != nullptr) {
+    this->hdlc_deframer_.set_buffer(this->telegram_, this->max_telegram_len_);
+  }
+  this->parser_.set_encoding(this->compact_output_ ? Encoding::COMPACT : Encoding::PADDED);
+#ifndef EFS_PRINT_VALUES
+  // Only objects with a sensor need to be parsed, unless all values are printed.
+  this->filter_ = this->sensors_.obis_codes<ObisCodes>();
+  this->parser_.set_filter(this->filter_.data(), this->filter_.size());
+  this->dlms_parser_.set_filter(this->filter_.data(), this->filter_.size());
+#endif
   if (this->request_pin_ != nullptr) {
     this->request_pin_->setup();
   }
 }
 
 void Efs::loop() {
+  this->loop_start_time_ = micros();
   if (this->ready_to_request_data_()) {
-    if (this->decryption_key_.empty()) {
-      this->receive_telegram_();
+    if (this->hdlc_) {
+      this->receive_(&Efs::process_hdlc_chunk_);
+    } else if (this->decryption_key_.empty()) {
+      this->receive_(&Efs::process_chunk_);
     } else {
-      this->receive_encrypted_telegram_();
+      this->receive_(&Efs::process_encrypted_chunk_);
     }
   }
+  // With double buffering, the previous telegram is dispatched while the next one is received
+  this->dispatch_objects_(true);
+  const uint32_t loop_time = micros() - this->loop_start_time_;
+  if (loop_time > this->max_loop_time_) {
+    this->max_loop_time_ = loop_time;
+  }
 }
 
 bool Efs::ready_to_request_data_() {
@@ -44,9 +77,7 @@ bool Efs::ready_to_request_data_() {
       this->start_requesting_data_();
     }
     if (!this->requesting_data_) {
-      while (this->available()) {
-        this->read();
-      }
+      this->discard_available_();
     }
   }
   return this->requesting_data_;
@@ -56,11 +87,14 @@ bool Efs::request_interval_reached_() {
   if (this->last_request_time_ == 0) {
     return true;
   }
-  return millis() - this->last_request_time_ > this->request_interval_;
+  // Always reached without an interval, also within the millisecond of the last request
+  return millis() - this->last_request_time_ >= this->request_interval_;
 }
 
 bool Efs::receive_timeout_reached_() { return millis() - this->last_read_time_ > this->receive_timeout_; }
 
+bool Efs::loop_budget_exhausted_() { return micros() - this->loop_start_time_ >= this->loop_budget_; }
+
 bool Efs::available_within_timeout_() {
   // Data are available for reading on the UART bus?
   // Then we can start reading right away.
@@ -69,27 +103,16 @@ bool Efs::available_within_timeout_() {
     return true;
   }
   // When we're not in the process of reading a telegram, then there is
-  // no need to actively wait for new data to come in.
+  // no need to wait for new data to come in.
   if (!header_found_) {
     return false;
   }
   // A telegram is being read. The smart meter might not deliver a telegram
   // in one go, but instead send it in chunks with small pauses in between.
-  // When the UART RX buffer cannot hold a full telegram, then make sure
-  // that the UART read buffer does not overflow while other components
-  // perform their work in their loop. Do this by not returning control to
-  // the main loop, until the read timeout is reached.
-  if (this->parent_->get_rx_buffer_size() < this->max_telegram_len_) {
-    while (!this->receive_timeout_reached_()) {
-      delay(5);
-      if (this->available()) {
-        this->last_read_time_ = millis();
-        return true;
-      }
-    }
-  }
-  // No new data has come in during the read timeout? Then stop reading the
-  // telegram and start waiting for the next one to arrive.
+  // Control is returned to the main loop, which runs at high frequency
+  // while the telegram is in flight so the UART is drained before its RX
+  // buffer overflows. No new data has come in during the read timeout?
+  // Then stop reading the telegram and start waiting for the next one.
   if (this->receive_timeout_reached_()) {
     ESP_LOGW(TAG, "Timeout while reading data for telegram");
     this->reset_telegram_();
@@ -116,148 +139,352 @@ void Efs::stop_requesting_data_() {
     if (this->request_pin_ != nullptr) {
       ESP_LOGV(TAG, "Stop requesting data from P1 port");
       this->request_pin_->digital_write(false);
+      // The meter stops sending, the rest belongs to the telegram that has been handled
+      this->discard_available_();
     } else {
+      // The meter keeps sending, the data are discarded by ready_to_request_data_() until the next request interval
       ESP_LOGV(TAG, "Stop reading data from P1 port");
     }
-    while (this->available()) {
-      this->read();
-    }
     this->requesting_data_ = false;
   }
 }
 
+void Efs::keep_unread_(const char *chunk, size_t size) {
+  this->unread_ = chunk;
+  this->unread_size_ = size;
+}
+
+void Efs::discard_available_() {
+  this->unread_size_ = 0;
+  drain_uart(*this, this->read_buffer_, sizeof(this->read_buffer_), [](const char *, size_t) { return true; });
+}
+
 void Efs::reset_telegram_() {
   this->header_found_ = false;
-  this->footer_found_ = false;
+  this->high_freq_.stop();
+  this->framer_.reset();
+  this->encrypted_framer_.reset();
+  if (this->telegram_pool_ != nullptr && this->telegram_ != nullptr) {
+    // The telegram has been dispatched or dropped
+    this->telegram_pool_->release(this->telegram_);
+    this->telegram_ = nullptr;
+  }
+  if (this->telegram_ != nullptr) {
+    // Double buffering may have swapped the telegram buffer
+    this->hdlc_deframer_.set_buffer(this->telegram_, this->max_telegram_len_);
+  }
   this->bytes_read_ = 0;
   this->crypt_bytes_read_ = 0;
-  this->crypt_telegram_len_ = 0;
+  this->binary_apdu_ = false;
   this->last_read_time_ = 0;
 }
 
-void Efs::receive_telegram_() {
-  while (this->available_within_timeout_()) {
-    const char c = this->read();
+bool Efs::acquire_telegram_() {
+  if (this->telegram_ != nullptr) {
+    return true;
+  }
+  if (this->telegram_pool_ != nullptr) {
+    this->telegram_ = this->telegram_pool_->acquire(this->pool_client_, millis());
+  }
+  if (this->telegram_ == nullptr) {
+    ++this->telegrams_skipped_;
+    ESP_LOGW(TAG, "No free telegram buffer in the pool, skipping telegram");
+    return false;
+  }
+  return true;
+}
+
+void Efs::receive_(bool (Efs::*process_chunk)(const char *chunk, size_t size)) {
+  bool done = false;
+  // The chunk in which the last telegram ended may hold the start of the next one
+  if (this->unread_size_ > 0) {
+    const size_t size = this->unread_size_;
+    this->unread_size_ = 0;
+    this->last_read_time_ = millis();
+    done = (this->*process_chunk)(this->unread_, size);
+  }
+  const auto process = [this, &done, process_chunk](const char *chunk, size_t size) {
+    done = (this->*process_chunk)(chunk, size);
+    return !done && !this->loop_budget_exhausted_();
+  };
+  // Stop reading when the loop budget is spent, the rest is read in the next loop
+  while (!done && !this->loop_budget_exhausted_() && this->available_within_timeout_()) {
+    drain_uart(*this, this->read_buffer_, sizeof(this->read_buffer_), process);
+  }
+}
+
+bool Efs::process_chunk_(const char *chunk, size_t size) {
+  while (size > 0) {
+    Frame frame;
+    const size_t consumed = this->framer_.next(chunk, size, frame);
+    chunk += consumed;
+    size -= consumed;
 
     // Find a new telegram header, i.e. forward slash.
-    if (c == '/') {
+    if (frame.start) {
       ESP_LOGV(TAG, "Header of telegram found");
-      this->reset_telegram_();
+      // The rest of the telegram is skipped while header_found_ is not set
+      if (!this->acquire_telegram_()) {
+        this->header_found_ = false;
+        continue;
+      }
       this->header_found_ = true;
+      this->high_freq_.start();
+      this->parser_.begin(this->telegram_, this->max_telegram_len_);
     }
-    if (!this->header_found_)
+    if (!this->header_found_ || frame.size == 0) {
       continue;
-
-    // Check for buffer overflow.
-    if (this->bytes_read_ >= this->max_telegram_len_) {
-      this->reset_telegram_();
-      ESP_LOGE(TAG, "Error: telegram larger than buffer (%d bytes)", this->max_telegram_len_);
-      return;
-    }
-
-    // Some v2.2 or v3 meters will send a new value which starts with '('
-    // in a new line, while the value belongs to the previous ObisId. For
-    // proper parsing, remove these new line characters.
-    if (c == '(') {
-      while (true) {
-        auto previous_char = this->telegram_[this->bytes_read_ - 1];
-        if (previous_char == '\n' || previous_char == '\r') {
-          this->bytes_read_--;
-        } else {
-          break;
-        }
-      }
     }
 
-    // Store the byte in the buffer.
-    this->telegram_[this->bytes_read_] = c;
-    this->bytes_read_++;
+    // Parse the bytes right away, the parsed telegram is written to the buffer. The received telegram may be larger
+    // than the buffer, the parser reports a write overflow if the parsed telegram does not fit.
+    this->parser_.feed(frame.data, frame.size);
 
-    // Check for a footer, i.e. exclamation mark, followed by a hex checksum.
-    if (c == '!') {
+    // The telegram ends with the newline after the footer, i.e. exclamation mark and hex checksum.
+    if (frame.end) {
       ESP_LOGV(TAG, "Footer of telegram found");
-      this->footer_found_ = true;
-      continue;
-    }
-    // Check for the end of the hex checksum, i.e. a newline.
-    if (this->footer_found_ && c == '\n') {
-      // Parse the telegram and publish sensor values.
-      this->parse_telegram();
+      // The rest of the chunk may hold the next telegram
+      this->keep_unread_(chunk, size);
+      // Finish parsing the telegram and publish sensor values.
+      this->publish_result_(this->parser_.finish());
       this->reset_telegram_();
-      return;
+      return true;
     }
   }
+  return false;
 }
 
-void Efs::receive_encrypted_telegram_() {
-  while (this->available_within_timeout_()) {
-    const char c = this->read();
+bool Efs::process_encrypted_chunk_(const char *chunk, size_t size) {
+  while (size > 0) {
+    Frame frame;
+    const size_t consumed = this->encrypted_framer_.next(chunk, size, frame);
+    chunk += consumed;
+    size -= consumed;
 
     // Find a new telegram start byte.
-    if (!this->header_found_) {
-      if ((uint8_t) c != 0xDB) {
-        continue;
-      }
+    if (frame.start) {
       ESP_LOGV(TAG, "Start byte 0xDB of encrypted telegram found");
-      this->reset_telegram_();
       this->header_found_ = true;
+      this->high_freq_.start();
+    }
+    if (!this->header_found_ || frame.size == 0) {
+      continue;
     }
 
-    // Check for buffer overflow.
-    if (this->crypt_bytes_read_ >= this->max_telegram_len_) {
+    // A telegram too short for the security header and tag may end before decryption has started.
+    const size_t telegram_size = this->encrypted_framer_.telegram_size();
+    if (telegram_size != 0 && telegram_size < CRYPT_HEADER_SIZE + GCM_TAG_SIZE) {
+      ESP_LOGE(TAG, "Error: encrypted telegram too short (%d bytes)", telegram_size);
       this->reset_telegram_();
-      ESP_LOGE(TAG, "Error: encrypted telegram larger than buffer (%d bytes)", this->max_telegram_len_);
-      return;
+      this->keep_unread_(chunk, size);
+      return true;
     }
 
-    // Store the byte in the buffer.
-    this->crypt_telegram_[this->crypt_bytes_read_] = c;
-    this->crypt_bytes_read_++;
+    const auto *data = reinterpret_cast<const uint8_t *>(frame.data);
+    size_t data_size = frame.size;
+    // Store the header, which holds the system title and frame counter of the IV.
+    if (this->crypt_bytes_read_ < CRYPT_HEADER_SIZE) {
+      const size_t header_size = std::min(data_size, CRYPT_HEADER_SIZE - this->crypt_bytes_read_);
+      std::memcpy(&this->crypt_header_[this->crypt_bytes_read_], data, header_size);
+      this->crypt_bytes_read_ += header_size;
+      data += header_size;
+      data_size -= header_size;
+      if (this->crypt_bytes_read_ == CRYPT_HEADER_SIZE && !this->start_decryption_()) {
+        this->reset_telegram_();
+        this->keep_unread_(chunk, size);
+        return true;
+      }
+    }
 
-    // Read the length of the incoming encrypted telegram.
-    if (this->crypt_telegram_len_ == 0 && this->crypt_bytes_read_ > 20) {
-      // Complete header + data bytes
-      this->crypt_telegram_len_ = 13 + (this->crypt_telegram_[11] << 8 | this->crypt_telegram_[12]);
-      ESP_LOGV(TAG, "Encrypted telegram length: %d bytes", this->crypt_telegram_len_);
+    // Decrypt the ciphertext as it arrives and parse it right away.
+    const size_t ciphertext_end = telegram_size - GCM_TAG_SIZE;
+    uint8_t plaintext[UART_CHUNK_SIZE + Gcm::MAX_HELD_BACK];
+    if (data_size > 0 && this->crypt_bytes_read_ < ciphertext_end) {
+      const size_t ciphertext_size = std::min(data_size, ciphertext_end - this->crypt_bytes_read_);
+      this->feed_plaintext_(plaintext, this->gcm_.decrypt(data, ciphertext_size, plaintext));
+      this->crypt_bytes_read_ += ciphertext_size;
+      data += ciphertext_size;
+      data_size -= ciphertext_size;
+    }
+    // Store the authentication tag that follows the ciphertext.
+    if (data_size > 0) {
+      std::memcpy(&this->crypt_tag_[this->crypt_bytes_read_ - ciphertext_end], data, data_size);
+      this->crypt_bytes_read_ += data_size;
     }
 
     // Check for the end of the encrypted telegram.
-    if (this->crypt_telegram_len_ == 0 || this->crypt_bytes_read_ != this->crypt_telegram_len_) {
-      continue;
+    if (frame.end) {
+      ESP_LOGV(TAG, "End of encrypted telegram found");
+      // The tag can only be verified with the authentication key.
+      const uint8_t *tag = this->authentication_key_.empty() ? nullptr : this->crypt_tag_;
+      const int plaintext_size = this->gcm_.finish(plaintext, tag, GCM_TAG_SIZE);
+      if (plaintext_size < 0) {
+        ESP_LOGE(TAG, "Error: authentication tag of encrypted telegram does not match, dropping telegram");
+        this->keep_unread_(chunk, size);
+        this->stop_requesting_data_();
+        this->reset_telegram_();
+        return true;
+      }
+      this->feed_plaintext_(plaintext, plaintext_size);
+      ESP_LOGV(TAG, "Decrypted telegram size: %d bytes", this->bytes_read_);
+      this->keep_unread_(chunk, size);
+      // Finish parsing the decrypted telegram and publish sensor values.
+      if (this->binary_apdu_) {
+        this->publish_result_(
+            this->dlms_parser_.parse_in_place(this->telegram_, this->max_telegram_len_, this->bytes_read_));
+      } else {
+        this->publish_result_(this->parser_.finish());
+      }
+      this->reset_telegram_();
+      return true;
     }
-    ESP_LOGV(TAG, "End of encrypted telegram found");
-
-    // Decrypt the encrypted telegram.
-    GCM<AES128> *gcmaes128{new GCM<AES128>()};
-    gcmaes128->setKey(this->decryption_key_.data(), gcmaes128->keySize());
-    // the iv is 8 bytes of the system title + 4 bytes frame counter
-    // system title is at byte 2 and frame counter at byte 15
-    for (int i = 10; i < 14; i++)
-      this->crypt_telegram_[i] = this->crypt_telegram_[i + 4];
-    constexpr uint16_t iv_size{12};
-    gcmaes128->setIV(&this->crypt_telegram_[2], iv_size);
-    gcmaes128->decrypt(reinterpret_cast<uint8_t *>(this->telegram_),
-                       // the ciphertext start at byte 18
-                       &this->crypt_telegram_[18],
-                       // cipher size
-                       this->crypt_bytes_read_ - 17);
-    delete gcmaes128;  // NOLINT(cppcoreguidelines-owning-memory)
-
-    this->bytes_read_ = strnlen(this->telegram_, this->max_telegram_len_);
-    ESP_LOGV(TAG, "Decrypted telegram size: %d bytes", this->bytes_read_);
-    ESP_LOGVV(TAG, "Decrypted telegram: %s", this->telegram_);
-
-    // Parse the decrypted telegram and publish sensor values.
-    this->parse_telegram();
-    this->reset_telegram_();
+  }
+  return false;
+}
+
+bool Efs::start_decryption_() {
+  const size_t telegram_size = this->encrypted_framer_.telegram_size();
+  ESP_LOGV(TAG, "Encrypted telegram length: %d bytes", telegram_size);
+  // Check for buffer overflow.
+  if (telegram_size - CRYPT_HEADER_SIZE - GCM_TAG_SIZE > this->max_telegram_len_) {
+    ESP_LOGE(TAG, "Error: encrypted telegram larger than buffer (%d bytes)", this->max_telegram_len_);
+    return false;
+  }
+  // system title is at byte 2, the security byte at byte 13 and frame counter at byte 14
+  if (!this->start_gcm_(&this->crypt_header_[2], this->crypt_header_[13], &this->crypt_header_[14]) ||
+      !this->acquire_telegram_()) {
+    return false;
+  }
+  this->parser_.begin(this->telegram_, this->max_telegram_len_);
+  return true;
+}
+
+bool Efs::start_gcm_(const uint8_t *system_title, uint8_t security_control, const uint8_t *frame_counter) {
+  // the iv is 8 bytes of the system title + 4 bytes frame counter
+  uint8_t iv[12];
+  std::memcpy(&iv[0], system_title, 8);
+  std::memcpy(&iv[8], frame_counter, 4);
+  // the additional authenticated data is the security byte + the authentication key
+  uint8_t aad[1 + KEY_SIZE];
+  aad[0] = security_control;
+  std::copy(this->authentication_key_.begin(), this->authentication_key_.end(), &aad[1]);
+  // The key schedule is kept from set_decryption_key(), starting only sets the IV
+  const size_t aad_size = this->authentication_key_.empty() ? 0 : sizeof(aad);
+  if (!this->gcm_.start(iv, sizeof(iv), aad, aad_size)) {
+    ESP_LOGE(TAG, "Error: unable to start decryption");
+    return false;
+  }
+  return true;
+}
+
+bool Efs::process_hdlc_chunk_(const char *chunk, size_t size) {
+  while (size > 0) {
+    HdlcEvent event;
+    const size_t consumed = this->hdlc_deframer_.next(chunk, size, event);
+    chunk += consumed;
+    size -= consumed;
+
+    switch (event) {
+      case HdlcEvent::NONE:
+        break;
+      case HdlcEvent::START:
+        if (!this->header_found_) {
+          ESP_LOGV(TAG, "HDLC frame found");
+          this->header_found_ = true;
+          this->high_freq_.start();
+        }
+        break;
+      case HdlcEvent::MESSAGE:
+        // The FCS of every segment has been verified, only now is the APDU decrypted and parsed.
+        this->bytes_read_ = this->hdlc_deframer_.size();
+        ESP_LOGV(TAG, "APDU of %d bytes received in HDLC frames", this->bytes_read_);
+        this->keep_unread_(chunk, size);
+        this->publish_apdu_();
+        this->reset_telegram_();
+        return true;
+      case HdlcEvent::MISSING_SEGMENT:
+        // Expected after a dropped segment or when reading starts in the middle of a message
+        ESP_LOGV(TAG, "HDLC segment without its first segment, skipping");
+        break;
+      case HdlcEvent::BUFFER_OVERFLOW:
+        ESP_LOGE(TAG, "Error: APDU larger than buffer (%d bytes)", this->max_telegram_len_);
+        break;
+      case HdlcEvent::INVALID_FRAME:
+      case HdlcEvent::INVALID_FCS:
+        ESP_LOGW(TAG, "Invalid HDLC %s, dropping telegram", event == HdlcEvent::INVALID_FCS ? "FCS" : "frame");
+        break;
+    }
+    // The deframer has dropped the message and continues with the next frame, which may share the closing flag
+    if (event != HdlcEvent::NONE && event != HdlcEvent::START) {
+      this->header_found_ = false;
+      this->high_freq_.stop();
+    }
+  }
+  return false;
+}
+
+bool Efs::publish_apdu_() {
+  auto *apdu = reinterpret_cast<uint8_t *>(this->telegram_);
+  size_t size = this->bytes_read_;
+  if (size > 0 && apdu[0] == dlms::GENERAL_GLO_CIPHERING) {
+    if (this->decryption_key_.empty()) {
+      ESP_LOGE(TAG, "Error: encrypted APDU received, but no decryption key is set");
+      return false;
+    }
+    dlms::CipheredApdu parts;
+    if (!dlms::split_ciphered_apdu(apdu, size, parts)) {
+      ESP_LOGE(TAG, "Error: invalid encrypted APDU");
+      return false;
+    }
+    // The tag can only be verified with the authentication key, which then must be present.
+    if (!this->authentication_key_.empty() && parts.tag == nullptr) {
+      ESP_LOGE(TAG, "Error: encrypted APDU is not authenticated, dropping telegram");
+      return false;
+    }
+    if (!this->start_gcm_(parts.system_title, parts.security_control, parts.frame_counter)) {
+      return false;
+    }
+    // Decrypt in place, then move the plaintext to the start of the buffer where the parsers expect it
+    const size_t plaintext_size = this->gcm_.decrypt(parts.ciphertext, parts.ciphertext_size, parts.ciphertext);
+    const uint8_t *tag = this->authentication_key_.empty() ? nullptr : parts.tag;
+    const int rest = this->gcm_.finish(&parts.ciphertext[plaintext_size], tag, dlms::AUTHENTICATION_TAG_SIZE);
+    if (rest < 0) {
+      ESP_LOGE(TAG, "Error: authentication tag of encrypted APDU does not match, dropping telegram");
+      return false;
+    }
+    size = plaintext_size + rest;
+    std::memmove(apdu, parts.ciphertext, size);
+  }
+  if (size > 0 && apdu[0] == dlms::DATA_NOTIFICATION) {
+    return this->publish_result_(this->dlms_parser_.parse_in_place(this->telegram_, this->max_telegram_len_, size));
+  }
+  // Some meters send P1 telegrams in HDLC frames
+  return this->publish_result_(this->parser_.parse_telegram(this->telegram_, size));
+}
+
+void Efs::feed_plaintext_(const uint8_t *plaintext, size_t size) {
+  if (size == 0) {
     return;
   }
+  // Meters which push DLMS/COSEM data encrypt an A-XDR encoded data notification instead of a P1 telegram.
+  if (this->bytes_read_ == 0) {
+    this->binary_apdu_ = plaintext[0] == dlms::DATA_NOTIFICATION;
+  }
+  // start_decryption_() has checked that the plaintext fits in the buffer
+  if (this->binary_apdu_) {
+    std::memcpy(&this->telegram_[this->bytes_read_], plaintext, size);
+  } else {
+    this->parser_.feed(reinterpret_cast<const char *>(plaintext), size);
+  }
+  this->bytes_read_ += size;
 }
 
-bool Efs::parse_telegram() {
-  this->stop_requesting_data_();
+bool Efs::publish_result_(const Result &result) {
+  // With double buffering the next telegram is received while this one is dispatched, unless it is not wanted yet
+  if (this->spare_telegram_ == nullptr || this->request_interval_ > 0) {
+    this->stop_requesting_data_();
+  }
 
-  const auto result = this->parser_.parse_telegram(this->telegram_, this->bytes_read_);
   const char *err_msg = nullptr;
   switch (result.status) {
     case Status::OK:
@@ -289,6 +516,9 @@ bool Efs::parse_telegram() {
     case Status::TOO_MANY_OBJECTS:
       err_msg = "Received a telegram with more than the allowed number of entries (255).";
       break;
+    case Status::TOO_MANY_VALUES:
+      err_msg = "Received an object with more than the allowed number of values (255).";
+      break;
     case Status::BUFFER_NOT_ALIGNED:
       err_msg = "The telegram buffer is not aligned to 2 bytes.";
       break;
@@ -304,93 +534,188 @@ bool Efs::parse_telegram() {
       ESP_LOGI(TAG, "%i-%i:%i.%i.%i", object.obis_code()[0], object.obis_code()[1], object.obis_code()[2],
                object.obis_code()[3], object.obis_code()[4]);
     } else if (object.num_values() == 1) {
-      const char *value = std::get<0>(*object.begin());
-      ESP_LOGI(TAG, "%i-%i:%i.%i.%i - %s", object.obis_code()[0], object.obis_code()[1], object.obis_code()[2],
-               object.obis_code()[3], object.obis_code()[4], value);
+      const auto [value, size] = *object.begin();
+      ESP_LOGI(TAG, "%i-%i:%i.%i.%i - %.*s", object.obis_code()[0], object.obis_code()[1], object.obis_code()[2],
+               object.obis_code()[3], object.obis_code()[4], static_cast<int>(size), value);
     } else {
       ESP_LOGI(TAG, "%i-%i:%i.%i.%i", object.obis_code()[0], object.obis_code()[1], object.obis_code()[2],
                object.obis_code()[3], object.obis_code()[4]);
-      for (const auto &value_tuple : object) {
-        const char *value = std::get<0>(value_tuple);
-        ESP_LOGI(TAG, " - %s", value);
+      // Compact values are not NUL-terminated
+      for (const auto &[value, size] : object) {
+        ESP_LOGI(TAG, " - %.*s", static_cast<int>(size), value);
       }
     }
   }
 #endif
 
-  for (const auto &object : result) {
-    const auto res = this->sensors_.find(object.obis_code());
-    if (res == this->sensors_.end()) {
-      continue;
-    }
-    const auto &sensor = res->second;
-    if (object.num_values() <= 0) {
-      ESP_LOGW(TAG, "No value found for OBIS code %i-%i:%i.%i.%i", object.obis_code()[0], object.obis_code()[1],
-               object.obis_code()[2], object.obis_code()[3], object.obis_code()[4]);
-      continue;
-    }
-    //
-    const char *data = std::get<0>(*object.begin());
-    char *value_end{};
-    const auto value = std::strtof(data, &value_end);
-    if (value_end == data) {
-      ESP_LOGE(TAG, "Error: Unable to parse \"%s\" as a floating point number", data);
-    } else if (value == HUGE_VALF) {
-      ESP_LOGE(TAG, "Floating point value overflow occured when parsing \"%s\"", data);
-    } else {
-      res->second->publish_state(value);
-    }
+  if (this->spare_telegram_ == nullptr) {
+    this->dispatch_it_ = result.begin();
+    this->dispatch_objects_(false);
+  } else {
+    // The remaining objects of the previous telegram must be dispatched before its buffer is reused
+    this->dispatch_objects_(false);
+    // Dispatch the objects in the following loops and receive the next telegram into the other buffer meanwhile
+    this->dispatch_it_ = result.begin();
+    std::swap(this->telegram_, this->spare_telegram_);
   }
 
   this->status_clear_warning();
   return true;
 }
 
+void Efs::dispatch_objects_(bool budgeted) {
+  const ObjectIterator end;
+  if (this->dispatch_it_ == end) {
+    return;
+  }
+  const uint32_t now = millis();
+  // At least one object is dispatched per call so that dispatching always progresses
+  do {
+    this->publish_object_(*this->dispatch_it_, now);
+    ++this->dispatch_it_;
+  } while (this->dispatch_it_ != end && !(budgeted && this->loop_budget_exhausted_()));
+  if (this->dispatch_it_ != end) {
+    return;
+  }
+  ESP_LOGV(TAG, "Objects decoded: %" PRIu32 ", skipped as unchanged: %" PRIu32, this->objects_decoded_,
+           this->objects_unchanged_);
+  ESP_LOGV(TAG, "Worst case loop time: %" PRIu32 " us", this->max_loop_time_);
+}
+
+void Efs::publish_object_(const Object &object, uint32_t now) {
+  const auto &obis_code = object.obis_code();
+  switch (this->sensors_.publish(object, now)) {
+    case PublishStatus::NO_SENSOR:
+      break;
+    case PublishStatus::NO_VALUE:
+      ESP_LOGW(TAG, "No value found for OBIS code %i-%i:%i.%i.%i", obis_code[0], obis_code[1], obis_code[2],
+               obis_code[3], obis_code[4]);
+      break;
+    case PublishStatus::UNCHANGED:
+      ++this->objects_unchanged_;
+      break;
+    case PublishStatus::DECODED:
+      ++this->objects_decoded_;
+      break;
+    case PublishStatus::NOT_A_NUMBER:
+      ++this->objects_decoded_;
+      ESP_LOGE(TAG, "Error: Unable to parse the value of %i-%i:%i.%i.%i as a number", obis_code[0], obis_code[1],
+               obis_code[2], obis_code[3], obis_code[4]);
+      break;
+    case PublishStatus::VALUE_OVERFLOW:
+      ++this->objects_decoded_;
+      ESP_LOGE(TAG, "Value overflow occured when converting the value of %i-%i:%i.%i.%i", obis_code[0], obis_code[1],
+               obis_code[2], obis_code[3], obis_code[4]);
+      break;
+  }
+}
+
 void Efs::dump_config() {
   ESP_LOGCONFIG(TAG, "EFS:");
   ESP_LOGCONFIG(TAG, "  Max telegram length: %d", this->max_telegram_len_);
+#ifdef EFS_STATIC_ALLOCATION
+  ESP_LOGCONFIG(TAG, "  Static allocation: %d sensors", MAX_SENSORS);
+#endif
   ESP_LOGCONFIG(TAG, "  Receive timeout: %.1fs", this->receive_timeout_ / 1e3f);
+  ESP_LOGCONFIG(TAG, "  Loop budget: %.1fms", this->loop_budget_ / 1e3f);
+  ESP_LOGCONFIG(TAG, "  Double buffering: %s", YESNO(this->spare_telegram_ != nullptr));
+  ESP_LOGCONFIG(TAG, "  HDLC: %s", YESNO(this->hdlc_));
+  ESP_LOGCONFIG(TAG, "  Compact output: %s", YESNO(this->compact_output_));
+  if (this->telegram_pool_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Telegram pool: %d buffers of %d bytes shared by %d meters",
+                  this->telegram_pool_->num_buffers(), this->telegram_pool_->buffer_size(),
+                  this->telegram_pool_->num_clients());
+    ESP_LOGCONFIG(TAG, "  Telegrams skipped without a free buffer: %" PRIu32, this->telegrams_skipped_);
+  }
+  if (!this->decryption_key_.empty()) {
+#ifdef EFS_GCM_MBEDTLS
+    ESP_LOGCONFIG(TAG, "  Decryption: mbedTLS");
+#else
+    ESP_LOGCONFIG(TAG, "  Decryption: software");
+#endif
+    ESP_LOGCONFIG(TAG, "  Verify authentication tag: %s", YESNO(!this->authentication_key_.empty()));
+  }
   if (this->request_pin_ != nullptr) {
     LOG_PIN("  Request Pin: ", this->request_pin_);
   }
   if (this->request_interval_ > 0) {
     ESP_LOGCONFIG(TAG, "  Request Interval: %.1fs", this->request_interval_ / 1e3f);
   }
+  ESP_LOGCONFIG(TAG, "  Objects decoded: %" PRIu32, this->objects_decoded_);
+  ESP_LOGCONFIG(TAG, "  Objects skipped as unchanged: %" PRIu32, this->objects_unchanged_);
+  ESP_LOGCONFIG(TAG, "  Worst case loop time: %.1fms", this->max_loop_time_ / 1e3f);
+}
+
+void Efs::set_telegram_pool(TelegramPool *pool) {
+#ifdef EFS_STATIC_ALLOCATION
+  (void) pool;
+  ESP_LOGE(TAG, "Error: the telegram pool can not be used with static allocation");
+#else
+  this->pool_client_ = pool->add_client(this->max_telegram_len_);
+  if (this->pool_client_ == TelegramPool::NO_CLIENT) {
+    ESP_LOGE(TAG, "Error: too many meters share the telegram pool, it holds %d", TelegramPool::MAX_CLIENTS);
+    return;
+  }
+  this->telegram_pool_ = pool;
+#endif
+}
+
+void Efs::add_sensor(const ObisCode &obis_code, sensor::Sensor *sensor, int8_t decimals,
+                     const PublishPolicy &policy) {
+  if (!this->sensors_.add(obis_code, sensor, decimals, policy)) {
+    ESP_LOGE(TAG, "Error: too many sensors, the sensor table holds %d", this->sensors_.size());
+  }
+}
+
+bool Efs::parse_key_(const std::string &hex, Key &key) {
+  key.clear();
+  if (hex.length() != KEY_SIZE * 2) {
+    return false;
+  }
+  char temp[3] = {0};
+  for (size_t i = 0; i < KEY_SIZE; i++) {
+    strncpy(temp, &(hex.c_str()[i * 2]), 2);
+    key.push_back(std::strtoul(temp, nullptr, 16));
+  }
+  return true;
 }
 
 void Efs::set_decryption_key(const std::string &decryption_key) {
   if (decryption_key.length() == 0) {
     ESP_LOGI(TAG, "Disabling decryption");
     this->decryption_key_.clear();
-    if (this->crypt_telegram_ != nullptr) {
-      delete[] this->crypt_telegram_;
-      this->crypt_telegram_ = nullptr;
-    }
     return;
   }
 
-  if (decryption_key.length() != 32) {
+  if (!parse_key_(decryption_key, this->decryption_key_)) {
     ESP_LOGE(TAG, "Error, decryption key must be 32 character long");
     return;
   }
-  this->decryption_key_.clear();
 
   ESP_LOGI(TAG, "Decryption key is set");
   // Verbose level prints decryption key
   ESP_LOGV(TAG, "Using decryption key: %s", decryption_key.c_str());
 
-  char temp[3] = {0};
-  for (int i = 0; i < 16; i++) {
-    strncpy(temp, &(decryption_key.c_str()[i * 2]), 2);
-    this->decryption_key_.push_back(std::strtoul(temp, nullptr, 16));
+  // The key schedule is only computed once, not for every telegram
+  if (!this->gcm_.set_key(this->decryption_key_.data(), this->decryption_key_.size())) {
+    ESP_LOGE(TAG, "Error, unable to set decryption key");
+    this->decryption_key_.clear();
   }
+}
 
-  if (this->crypt_telegram_ == nullptr) {
-    this->crypt_telegram_ = new uint8_t[this->max_telegram_len_];  // NOLINT
+void Efs::set_authentication_key(const std::string &authentication_key) {
+  if (authentication_key.length() == 0) {
+    this->authentication_key_.clear();
+    return;
+  }
+  if (!parse_key_(authentication_key, this->authentication_key_)) {
+    ESP_LOGE(TAG, "Error, authentication key must be 32 character long");
+    return;
   }
+  ESP_LOGI(TAG, "Authentication key is set, the tag of encrypted telegrams is verified");
 }
 
 }  // namespace efs
 }  // namespace esphome
 
-#endif  // USE_ARDUINO
+#endif  // USE_ARDUINO || USE_ESP_IDF
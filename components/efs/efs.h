@@ -1,23 +1,56 @@
 #pragma once
 
-#ifdef USE_ARDUINO
+#if defined(USE_ARDUINO) || defined(USE_ESP_IDF)
 
+#include "dlms_parser.h"
+#include "framer.h"
+#include "gcm.h"
+#include "hdlc.h"
 #include "obis_code.h"
 #include "parser.h"
+#include "sensor_table.h"
+#include "static_vector.h"
+#include "telegram_pool.h"
 
 #include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 #include "esphome/components/uart/uart.h"
 #include "esphome/core/log.h"
 #include "esphome/core/defines.h"
 
-#include <map>
+#include <string>
 #include <vector>
 
 namespace esphome {
 namespace efs {
 
+/// Number of bytes read from the UART at a time.
+static constexpr size_t UART_CHUNK_SIZE = 128;
+/// Header of an encrypted telegram up to the ciphertext: the frame header, security byte and frame counter.
+static constexpr size_t CRYPT_HEADER_SIZE = EncryptedTelegramFramer::HEADER_SIZE + 5;
+/// The authentication tag at the end of an encrypted telegram.
+static constexpr size_t GCM_TAG_SIZE = 12;
+/// Size of the decryption and authentication keys.
+static constexpr size_t KEY_SIZE = 16;
+using Key = StaticVector<uint8_t, KEY_SIZE>;
+
+#ifdef EFS_STATIC_ALLOCATION
+#ifndef EFS_TELEGRAM_BUFFERS
+#define EFS_TELEGRAM_BUFFERS 1
+#endif
+// The telegram buffers and sensor table have capacities fixed at compile time, so that nothing is allocated from
+// the heap after boot.
+static constexpr size_t MAX_TELEGRAM_LENGTH = EFS_MAX_TELEGRAM_LENGTH;
+static constexpr size_t MAX_SENSORS = EFS_MAX_SENSORS;
+using SensorEntries = StaticVector<SensorEntry<sensor::Sensor>, MAX_SENSORS>;
+using ObisCodes = StaticVector<ObisCode, MAX_SENSORS>;
+#else
+using SensorEntries = std::vector<SensorEntry<sensor::Sensor>>;
+using ObisCodes = std::vector<ObisCode>;
+#endif
+
 class Efs : public Component, public uart::UARTDevice {
  public:
   Efs(uart::UARTComponent *uart) : uart::UARTDevice(uart) {}
@@ -25,32 +58,95 @@ class Efs : public Component, public uart::UARTDevice {
   void setup() override;
   void loop() override;
 
-  bool parse_telegram();
+  /// Number of objects with a sensor whose values have been decoded.
+  uint32_t get_objects_decoded() const { return this->objects_decoded_; }
+  /// Number of objects with a sensor that were skipped since their values were unchanged.
+  uint32_t get_objects_unchanged() const { return this->objects_unchanged_; }
+  /// Longest time spent in a single call to loop() since boot, in microseconds.
+  uint32_t get_max_loop_time() const { return this->max_loop_time_; }
 
   void dump_config() override;
 
   void set_decryption_key(const std::string &decryption_key);
+  /// Set the key that is part of the additional authenticated data, the tag of encrypted telegrams is only
+  /// verified when it is set.
+  void set_authentication_key(const std::string &authentication_key);
   void set_max_telegram_length(size_t length) { this->max_telegram_len_ = length; }
   void set_request_pin(GPIOPin *request_pin) { this->request_pin_ = request_pin; }
   void set_request_interval(uint32_t interval) { this->request_interval_ = interval; }
   void set_receive_timeout(uint32_t timeout) { this->receive_timeout_ = timeout; }
-  void add_sensor(const ObisCode &obis_code, sensor::Sensor *sensor) { this->sensors_.emplace(obis_code, sensor); }
+  /// Set the time in microseconds that loop() may spend reading a telegram before returning to the main loop.
+  void set_loop_budget(uint32_t budget) { this->loop_budget_ = budget; }
+  /// Receive the next telegram into a second buffer while the previous one is dispatched, at the cost of
+  /// another max telegram length bytes of RAM. Without a request interval, reading then continues right after a
+  /// telegram and a request pin is kept on.
+  void set_double_buffer(bool double_buffer) { this->double_buffer_ = double_buffer; }
+  /// Receive DLMS/COSEM APDUs in HDLC frames instead of plain or encrypted P1 telegrams.
+  void set_hdlc(bool hdlc) { this->hdlc_ = hdlc; }
+  /// Parse P1 telegrams to the compact output encoding, so that an unencrypted telegram which is larger than the max
+  /// telegram length fits as long as its parsed objects do.
+  void set_compact_output(bool compact_output) { this->compact_output_ = compact_output; }
+  /// Borrow the telegram buffer from pool while a telegram is received and parsed, instead of allocating one.
+  ///
+  /// Call after set_max_telegram_length(). Telegrams that start while no
+  /// buffer is free for this meter are skipped. Not used with HDLC or double
+  /// buffering.
+  void set_telegram_pool(TelegramPool *pool);
+  /// Reserve space for num_sensors sensors before they are added.
+  void reserve_sensors(size_t num_sensors) { this->sensors_.reserve(num_sensors); }
+  /// Add a sensor for the first value of the object with obis_code.
+  ///
+  /// For timestamped submeter readings, the last value is published and only
+  /// when the timestamp has changed since the previous telegram. Several
+  /// sensors may be added for the same OBIS code.
+  ///
+  /// The value is rounded to decimals decimals before it is published, or
+  /// published as is with NO_ROUNDING. The rounded value is then only
+  /// published when policy allows it.
+  void add_sensor(const ObisCode &obis_code, sensor::Sensor *sensor, int8_t decimals = NO_ROUNDING,
+                  const PublishPolicy &policy = {});
 
  protected:
-  void receive_telegram_();
-  void receive_encrypted_telegram_();
+  /// Read the UART in chunks and pass them to process_chunk until a telegram has been handled, the loop budget is
+  /// spent or no more data are available.
+  void receive_(bool (Efs::*process_chunk)(const char *chunk, size_t size));
+  /// Frame and parse a chunk of received data, returns true when a telegram has been handled.
+  ///
+  /// The bytes after the end of the telegram are kept with keep_unread_() and
+  /// processed first by the next call to receive_().
+  bool process_chunk_(const char *chunk, size_t size);
+  bool process_encrypted_chunk_(const char *chunk, size_t size);
+  bool process_hdlc_chunk_(const char *chunk, size_t size);
+  /// Set the IV from the header of an encrypted telegram, returns false if the telegram can not be decrypted.
+  bool start_decryption_();
+  bool start_gcm_(const uint8_t *system_title, uint8_t security_control, const uint8_t *frame_counter);
+  /// Decrypt and parse the APDU of bytes_read_ bytes in the telegram buffer, received in HDLC frames.
+  bool publish_apdu_();
+  /// Parse decrypted bytes as P1 text, or store them if the telegram is a binary DLMS push.
+  void feed_plaintext_(const uint8_t *plaintext, size_t size);
+  /// Parse a key of KEY_SIZE bytes from hex, returns false if it has the wrong length.
+  static bool parse_key_(const std::string &hex, Key &key);
+  /// Keep the rest of the chunk that has been read from the UART for the next receive_().
+  void keep_unread_(const char *chunk, size_t size);
+  /// Discard the data in the UART RX buffer and the unread rest of the last chunk.
+  void discard_available_();
   void reset_telegram_();
-
-  /// Wait for UART data to become available within the read timeout.
+  /// Borrow a telegram buffer from the pool if none is held, returns false if none is free.
+  bool acquire_telegram_();
+  bool publish_result_(const Result &result);
+  /// Publish the objects from dispatch_it_ until all are published or, if budgeted, the loop budget is spent.
+  void dispatch_objects_(bool budgeted);
+  void publish_object_(const Object &object, uint32_t now);
+
+  /// Check if UART data are available, resetting the telegram when none have arrived within the read timeout.
   ///
   /// The smart meter might provide data in chunks, causing available() to
-  /// return 0. When we're already reading a telegram, then we don't return
-  /// right away (to handle further data in an upcoming loop) but wait a
-  /// little while using this method to see if more data are incoming.
-  /// By not returning, we prevent other components from taking so much
-  /// time that the UART RX buffer overflows and bytes of the telegram get
-  /// lost in the process.
+  /// return 0. This never blocks, instead the main loop is requested to run
+  /// at high frequency while a telegram is being read so that the UART RX
+  /// buffer is drained before it overflows.
   bool available_within_timeout_();
+  /// Check if the time budget of the current loop() call has been spent.
+  bool loop_budget_exhausted_();
 
   // Request telegram
   uint32_t request_interval_;
@@ -67,20 +163,50 @@ class Efs : public Component, public uart::UARTDevice {
   bool receive_timeout_reached_();
   size_t max_telegram_len_;
   char *telegram_{nullptr};
+#ifdef EFS_STATIC_ALLOCATION
+  alignas(4) char telegram_storage_[EFS_TELEGRAM_BUFFERS][MAX_TELEGRAM_LENGTH];
+#endif
+  TelegramPool *telegram_pool_{nullptr};
+  uint8_t pool_client_{TelegramPool::NO_CLIENT};
+  uint32_t telegrams_skipped_{0};
+  // Holds the telegram being dispatched when double buffering
+  char *spare_telegram_{nullptr};
+  bool double_buffer_{false};
+  uint8_t read_buffer_[UART_CHUNK_SIZE];
+  // The rest of the chunk in read_buffer_ after the end of the last telegram, which may hold the next one
+  const char *unread_{nullptr};
+  size_t unread_size_{0};
   size_t bytes_read_{0};
-  uint8_t *crypt_telegram_{nullptr};
-  size_t crypt_telegram_len_{0};
+  uint8_t crypt_header_[CRYPT_HEADER_SIZE]{};
+  uint8_t crypt_tag_[GCM_TAG_SIZE]{};
   size_t crypt_bytes_read_{0};
+  // Set when the decrypted telegram is a binary DLMS push instead of P1 text
+  bool binary_apdu_{false};
   uint32_t last_read_time_{0};
   bool header_found_{false};
-  bool footer_found_{false};
+  HighFrequencyLoopRequester high_freq_;
+  uint32_t loop_budget_{10000};
+  uint32_t loop_start_time_{0};
+  uint32_t max_loop_time_{0};
+  TelegramFramer framer_{};
+  EncryptedTelegramFramer encrypted_framer_{};
+  bool hdlc_{false};
+  bool compact_output_{false};
+  HdlcDeframer hdlc_deframer_{};
 
   Parser parser_;
-
-  std::map<ObisCode, sensor::Sensor *> sensors_{};
-  std::vector<uint8_t> decryption_key_{};
+  DlmsParser dlms_parser_;
+
+  SensorTable<sensor::Sensor, SensorEntries> sensors_{};
+  ObjectIterator dispatch_it_{};
+  uint32_t objects_decoded_{0};
+  uint32_t objects_unchanged_{0};
+  ObisCodes filter_{};
+  Key decryption_key_{};
+  Key authentication_key_{};
+  Gcm gcm_;
 };
 }  // namespace efs
 }  // namespace esphome
 
-#endif  // USE_ARDUINO
+#endif  // USE_ARDUINO || USE_ESP_IDF
@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "scan.h"
+
+namespace esphome {
+namespace efs {
+
+/// Part of a telegram found by a framer.
+struct Frame {
+  /// The bytes belonging to the telegram, size is 0 if there are none.
+  const char *data;
+  size_t size;
+  /// The telegram starts with data.
+  bool start;
+  /// The telegram ends with data.
+  bool end;
+};
+
+/// Finds plain text telegrams, from '/' to the newline after the '!' footer, in a stream of chunks.
+class TelegramFramer {
+ public:
+  /// Scan the next part of chunk, returns the number of bytes consumed.
+  ///
+  /// Call repeatedly until the whole chunk is consumed, each call finds at
+  /// most one start or end of a telegram. A '/' always starts a new
+  /// telegram, discarding an incomplete one.
+  size_t next(const char *chunk, size_t size, Frame &frame) {
+    frame = Frame{chunk, 0, false, false};
+    const char *const end = &chunk[size];
+    const char *pos = chunk;
+    if (size > 0 && *chunk == '/') {
+      state_ = State::SEARCH;
+    }
+    if (state_ == State::SEARCH) {
+      pos = static_cast<const char *>(std::memchr(chunk, '/', size));
+      if (pos == nullptr) {
+        return size;
+      }
+      frame = Frame{pos, 0, true, false};
+      state_ = State::BODY;
+      ++pos;
+    }
+    while (pos != end) {
+      if (state_ == State::BODY) {
+        pos = util::find_first_of<'/', '!'>(pos, end);
+        if (pos != end && *pos == '!') {
+          state_ = State::FOOTER;
+          ++pos;
+        }
+      } else {
+        pos = util::find_first_of<'/', '\n'>(pos, end);
+        if (pos != end && *pos == '\n') {
+          ++pos;
+          frame.end = true;
+          state_ = State::SEARCH;
+          break;
+        }
+      }
+      if (pos != end && *pos == '/') {
+        // Start of the next telegram, which is returned by the next call
+        state_ = State::SEARCH;
+        break;
+      }
+    }
+    frame.size = pos - frame.data;
+    return pos - chunk;
+  }
+
+  void reset() { state_ = State::SEARCH; }
+
+ protected:
+  enum class State : uint8_t { SEARCH, BODY, FOOTER };
+
+  State state_{State::SEARCH};
+};
+
+/// Finds encrypted telegrams, starting with 0xDB and ending after the length from their header, in a stream of chunks.
+class EncryptedTelegramFramer {
+ public:
+  static constexpr uint8_t START_BYTE = 0xDB;
+  /// Start byte, system title length, 8 byte system title, 0x82 and 2 byte length.
+  static constexpr size_t HEADER_SIZE = 13;
+
+  /// Scan the next part of chunk, returns the number of bytes consumed.
+  ///
+  /// Call repeatedly until the whole chunk is consumed, each call finds at
+  /// most one start or end of a telegram.
+  size_t next(const char *chunk, size_t size, Frame &frame) {
+    frame = Frame{chunk, 0, false, false};
+    const char *pos = chunk;
+    if (bytes_read_ == 0 || bytes_read_ == telegram_size()) {
+      pos = static_cast<const char *>(std::memchr(chunk, START_BYTE, size));
+      if (pos == nullptr) {
+        return size;
+      }
+      reset();
+      frame = Frame{pos, 0, true, false};
+    }
+    const char *const end = &chunk[size];
+    // Read the length from the header
+    for (; pos != end && bytes_read_ < HEADER_SIZE; ++pos, ++bytes_read_) {
+      if (bytes_read_ == HEADER_SIZE - 2) {
+        telegram_size_ = HEADER_SIZE + (static_cast<uint8_t>(*pos) << 8);
+      } else if (bytes_read_ == HEADER_SIZE - 1) {
+        telegram_size_ += static_cast<uint8_t>(*pos);
+      }
+    }
+    if (bytes_read_ >= HEADER_SIZE) {
+      const size_t remaining = std::min<size_t>(telegram_size_ - bytes_read_, end - pos);
+      pos += remaining;
+      bytes_read_ += remaining;
+      frame.end = bytes_read_ == telegram_size_;
+    }
+    frame.size = pos - frame.data;
+    return pos - chunk;
+  }
+
+  /// Size of the current or last telegram including its header, 0 until the header has been read.
+  size_t telegram_size() const { return bytes_read_ < HEADER_SIZE ? 0 : telegram_size_; }
+
+  void reset() {
+    bytes_read_ = 0;
+    telegram_size_ = 0;
+  }
+
+ protected:
+  size_t bytes_read_{0};
+  size_t telegram_size_{0};
+};
+
+/// Read all bytes available from uart in chunks of at most buffer_size bytes, passing each chunk to callback.
+///
+/// Uses read_array() instead of reading byte by byte. Returns the number of bytes read.
+template<typename Uart, typename Callback>
+size_t drain_uart(Uart &uart, uint8_t *buffer, size_t buffer_size, Callback &&callback) {
+  size_t total = 0;
+  for (int available = uart.available(); available > 0; available = uart.available()) {
+    const size_t size = std::min<size_t>(available, buffer_size);
+    if (!uart.read_array(buffer, size)) {
+      break;
+    }
+    total += size;
+    if (!callback(reinterpret_cast<const char *>(buffer), size)) {
+      break;
+    }
+  }
+  return total;
+}
+
+}  // namespace efs
+}  // namespace esphome
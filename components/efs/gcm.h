@@ -0,0 +1,173 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// AES-128-GCM decryption backends, select one with EFS_GCM_MBEDTLS or EFS_GCM_SOFTWARE. Gcm is an alias of the
+// selected backend.
+//
+// A backend decrypts a stream of ciphertext in chunks of any size:
+//   set_key(key, size)                    Set up the key schedule, once for all telegrams.
+//   start(iv, iv_size, aad, aad_size)     Start decrypting a telegram.
+//   decrypt(input, size, output)          Returns the number of bytes written to output, which may lag behind the
+//                                         input by up to MAX_HELD_BACK bytes.
+//   finish(output, tag, tag_size)         Writes the held back bytes to output and returns their number, or -1 if
+//                                         tag does not match. The tag is not checked if it is nullptr.
+#if defined(EFS_GCM_MBEDTLS)
+#include <mbedtls/gcm.h>
+#include <mbedtls/version.h>
+#elif defined(EFS_GCM_SOFTWARE)
+#include <AES.h>
+#include <Crypto.h>
+#include <GCM.h>
+#endif
+
+namespace esphome {
+namespace efs {
+
+namespace util {
+/// Compare two tags in constant time.
+inline bool tags_equal(const uint8_t *lhs, const uint8_t *rhs, size_t size) {
+  uint8_t diff = 0;
+  for (size_t i = 0; i < size; ++i) {
+    diff |= lhs[i] ^ rhs[i];
+  }
+  return diff == 0;
+}
+}  // namespace util
+
+#if defined(EFS_GCM_MBEDTLS)
+/// AES-128-GCM using mbedTLS, which uses the hardware AES accelerator of the ESP32.
+class MbedtlsGcm {
+ public:
+  static constexpr size_t BLOCK_SIZE = 16;
+#if MBEDTLS_VERSION_MAJOR >= 3
+  static constexpr size_t MAX_HELD_BACK = 0;
+#else
+  // mbedTLS 2 only accepts whole blocks until the last update
+  static constexpr size_t MAX_HELD_BACK = BLOCK_SIZE - 1;
+#endif
+
+  MbedtlsGcm() { mbedtls_gcm_init(&ctx_); }
+  ~MbedtlsGcm() { mbedtls_gcm_free(&ctx_); }
+  MbedtlsGcm(const MbedtlsGcm &) = delete;
+  MbedtlsGcm &operator=(const MbedtlsGcm &) = delete;
+
+  bool set_key(const uint8_t *key, size_t size) {
+    return mbedtls_gcm_setkey(&ctx_, MBEDTLS_CIPHER_ID_AES, key, size * 8) == 0;
+  }
+
+  bool start(const uint8_t *iv, size_t iv_size, const uint8_t *aad, size_t aad_size) {
+    held_back_size_ = 0;
+#if MBEDTLS_VERSION_MAJOR >= 3
+    return mbedtls_gcm_starts(&ctx_, MBEDTLS_GCM_DECRYPT, iv, iv_size) == 0 &&
+           (aad_size == 0 || mbedtls_gcm_update_ad(&ctx_, aad, aad_size) == 0);
+#else
+    return mbedtls_gcm_starts(&ctx_, MBEDTLS_GCM_DECRYPT, iv, iv_size, aad, aad_size) == 0;
+#endif
+  }
+
+  size_t decrypt(const uint8_t *input, size_t size, uint8_t *output) {
+#if MBEDTLS_VERSION_MAJOR >= 3
+    size_t output_size = 0;
+    mbedtls_gcm_update(&ctx_, input, size, output, size, &output_size);
+    return output_size;
+#else
+    size_t written = 0;
+    // Complete the block held back by the previous call first
+    if (held_back_size_ > 0) {
+      const size_t fill_size = std::min(size, BLOCK_SIZE - held_back_size_);
+      std::memcpy(&held_back_[held_back_size_], input, fill_size);
+      held_back_size_ += fill_size;
+      input += fill_size;
+      size -= fill_size;
+      if (held_back_size_ < BLOCK_SIZE) {
+        return 0;
+      }
+      mbedtls_gcm_update(&ctx_, BLOCK_SIZE, held_back_, output);
+      held_back_size_ = 0;
+      written = BLOCK_SIZE;
+    }
+    const size_t blocks_size = size - size % BLOCK_SIZE;
+    if (blocks_size > 0) {
+      mbedtls_gcm_update(&ctx_, blocks_size, input, &output[written]);
+      written += blocks_size;
+    }
+    held_back_size_ = size - blocks_size;
+    std::memcpy(held_back_, &input[blocks_size], held_back_size_);
+    return written;
+#endif
+  }
+
+  int finish(uint8_t *output, const uint8_t *tag, size_t tag_size) {
+    uint8_t computed_tag[BLOCK_SIZE];
+    tag_size = std::min(tag_size, BLOCK_SIZE);
+#if MBEDTLS_VERSION_MAJOR >= 3
+    size_t written = 0;
+    if (mbedtls_gcm_finish(&ctx_, output, MAX_HELD_BACK, &written, computed_tag, BLOCK_SIZE) != 0) {
+      return -1;
+    }
+#else
+    const size_t written = held_back_size_;
+    if (written > 0) {
+      mbedtls_gcm_update(&ctx_, written, held_back_, output);
+      held_back_size_ = 0;
+    }
+    if (mbedtls_gcm_finish(&ctx_, computed_tag, BLOCK_SIZE) != 0) {
+      return -1;
+    }
+#endif
+    // A truncated tag is the start of the full tag
+    if (tag != nullptr && !util::tags_equal(computed_tag, tag, tag_size)) {
+      return -1;
+    }
+    return static_cast<int>(written);
+  }
+
+ protected:
+  mbedtls_gcm_context ctx_;
+  uint8_t held_back_[BLOCK_SIZE];
+  size_t held_back_size_{0};
+};
+
+using Gcm = MbedtlsGcm;
+#elif defined(EFS_GCM_SOFTWARE)
+/// AES-128-GCM in software using the rweather/Crypto library.
+class SoftwareGcm {
+ public:
+  static constexpr size_t MAX_HELD_BACK = 0;
+
+  bool set_key(const uint8_t *key, size_t size) { return gcm_.setKey(key, size); }
+
+  bool start(const uint8_t *iv, size_t iv_size, const uint8_t *aad, size_t aad_size) {
+    if (!gcm_.setIV(iv, iv_size)) {
+      return false;
+    }
+    if (aad_size > 0) {
+      gcm_.addAuthData(aad, aad_size);
+    }
+    return true;
+  }
+
+  size_t decrypt(const uint8_t *input, size_t size, uint8_t *output) {
+    gcm_.decrypt(output, input, size);
+    return size;
+  }
+
+  int finish(uint8_t * /*output*/, const uint8_t *tag, size_t tag_size) {
+    if (tag != nullptr && !gcm_.checkTag(tag, tag_size)) {
+      return -1;
+    }
+    return 0;
+  }
+
+ protected:
+  GCM<AES128> gcm_;
+};
+
+using Gcm = SoftwareGcm;
+#endif
+
+}  // namespace efs
+}  // namespace esphome
@@ -0,0 +1,272 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "crc16.h"
+
+namespace esphome {
+namespace efs {
+
+/// Outcome of HdlcDeframer::next().
+enum class HdlcEvent : uint8_t {
+  NONE,
+  /// The header of a frame which may start a message has been received.
+  START,
+  /// A complete message has been reassembled, see HdlcDeframer::data().
+  MESSAGE,
+  /// The frame format, header check sequence or closing flag is wrong, the message is dropped.
+  INVALID_FRAME,
+  /// The frame check sequence is wrong, the message is dropped.
+  INVALID_FCS,
+  /// A segment which does not start a message was received without its first segment, or a segment in between is
+  /// missing. The message is dropped.
+  MISSING_SEGMENT,
+  /// The message is larger than the buffer, the message is dropped.
+  BUFFER_OVERFLOW,
+};
+
+/// Extracts messages from the HDLC frames used by DLMS/COSEM meters, in a stream of chunks.
+///
+/// A frame is delimited by 0x7E flags and holds a format field with the
+/// segmentation bit and frame length, the addresses, a control byte, the
+/// header check sequence (HCS), the information field and the frame check
+/// sequence (FCS). Frames are not byte stuffed. The information fields of a
+/// segmented message are copied straight from the chunks to the buffer, each
+/// after the previous one, and a segment only becomes part of the message
+/// once its FCS has been verified. The LLC header of the first segment is
+/// left out, so the buffer holds the bare APDU. Segments sent as I frames
+/// carry a send sequence number, a gap in the sequence drops the message.
+class HdlcDeframer {
+ public:
+  static constexpr uint8_t FLAG = 0x7E;
+  /// Destination and source LLC address and quality, in front of the APDU of the first segment.
+  static constexpr size_t LLC_SIZE = 3;
+  /// Addresses are at most 4 bytes each.
+  static constexpr size_t MAX_ADDRESS_SIZE = 8;
+
+  /// Set the buffer that messages are reassembled in.
+  void set_buffer(char *buffer, size_t size) {
+    buffer_ = buffer;
+    buffer_size_ = size;
+    reset();
+  }
+
+  /// Scan the next part of chunk, returns the number of bytes consumed.
+  ///
+  /// Call repeatedly until the whole chunk is consumed, each call reports at
+  /// most one event.
+  size_t next(const char *chunk, size_t size, HdlcEvent &event) {
+    event = HdlcEvent::NONE;
+    const auto *pos = reinterpret_cast<const uint8_t *>(chunk);
+    const uint8_t *const end = &pos[size];
+    while (pos != end && event == HdlcEvent::NONE) {
+      switch (state_) {
+        case State::SEARCH: {
+          const auto *flag = static_cast<const uint8_t *>(std::memchr(pos, FLAG, end - pos));
+          if (flag == nullptr) {
+            return size;
+          }
+          pos = flag + 1;
+          state_ = State::FORMAT;
+          header_size_ = 0;
+          break;
+        }
+        case State::HEADER:
+        case State::FORMAT:
+          event = read_header_(*pos++);
+          break;
+        case State::INFO:
+          pos = read_info_(pos, end);
+          break;
+        case State::FCS:
+          fcs_.update(static_cast<char>(*pos++));
+          if (++fcs_bytes_read_ == 2) {
+            state_ = State::CLOSING_FLAG;
+          }
+          break;
+        case State::CLOSING_FLAG:
+          event = end_frame_(*pos++);
+          break;
+      }
+    }
+    return pos - reinterpret_cast<const uint8_t *>(chunk);
+  }
+
+  /// The reassembled APDU, valid after a MESSAGE event until more data is scanned.
+  const char *data() const { return buffer_; }
+  size_t size() const { return message_size_; }
+
+  /// Drop the message being reassembled and search for the next frame.
+  ///
+  /// A flag that has just been scanned still opens the next frame, since the
+  /// closing flag of a frame may be shared with the next one.
+  void reset() {
+    if (state_ != State::FORMAT) {
+      state_ = State::SEARCH;
+    }
+    drop_message_();
+  }
+
+ protected:
+  enum class State : uint8_t { SEARCH, FORMAT, HEADER, INFO, FCS, CLOSING_FLAG };
+
+  // The header is read a byte at a time, it holds the format (2), addresses (2-8), control (1) and HCS (2) bytes.
+  HdlcEvent read_header_(uint8_t byte) {
+    if (state_ == State::FORMAT) {
+      if (byte == FLAG) {
+        // Idle flags between frames
+        return HdlcEvent::NONE;
+      }
+      // Frame format type 3
+      if ((byte & 0xF0) != 0xA0) {
+        return invalid_frame_();
+      }
+      fcs_.reset();
+      state_ = State::HEADER;
+      addresses_found_ = 0;
+      address_end_ = 0;
+    }
+    fcs_.update(static_cast<char>(byte));
+    ++header_size_;
+    if (header_size_ == 1) {
+      segmented_ = (byte & 0x08) != 0;
+      frame_size_ = (byte & 0x07) << 8;
+    } else if (header_size_ == 2) {
+      frame_size_ |= byte;
+    } else if (addresses_found_ < 2) {
+      // The last byte of an address has bit 0 set
+      if (header_size_ - 2 > MAX_ADDRESS_SIZE) {
+        return invalid_frame_();
+      }
+      if ((byte & 0x01) != 0 && ++addresses_found_ == 2) {
+        address_end_ = header_size_;
+      }
+    } else if (header_size_ == address_end_ + 1) {
+      // I frames have bit 0 of the control byte clear and their send sequence number N(S) in bits 1-3
+      sequenced_ = (byte & 0x01) == 0;
+      send_sequence_ = (byte >> 1) & 0x07;
+    } else if (header_size_ == address_end_ + 3) {
+      // Control byte and HCS read
+      return start_info_();
+    }
+    return HdlcEvent::NONE;
+  }
+
+  HdlcEvent start_info_() {
+    // A frame without information field ends with the HCS, otherwise the information field is followed by the FCS
+    if (fcs_.crc() != FCS16_GOOD || (frame_size_ != header_size_ && frame_size_ < header_size_ + 2)) {
+      return invalid_frame_();
+    }
+    info_remaining_ = frame_size_ == header_size_ ? 0 : frame_size_ - header_size_ - 2;
+    has_info_ = info_remaining_ > 0;
+    first_segment_ = !in_message_;
+    info_read_ = 0;
+    segment_size_ = 0;
+    fcs_bytes_read_ = 0;
+    const size_t apdu_size = info_remaining_ - (first_segment_ ? std::min(info_remaining_, LLC_SIZE) : 0);
+    overflow_ = apdu_size > buffer_size_ - write_pos_;
+    state_ = has_info_ ? State::INFO : State::CLOSING_FLAG;
+    return first_segment_ && has_info_ ? HdlcEvent::START : HdlcEvent::NONE;
+  }
+
+  const uint8_t *read_info_(const uint8_t *pos, const uint8_t *end) {
+    const size_t size = std::min<size_t>(info_remaining_, end - pos);
+    fcs_.update(reinterpret_cast<const char *>(pos), size);
+    const uint8_t *data = pos;
+    size_t data_size = size;
+    // The LLC header of the first segment is not part of the APDU, it is checked when the frame is complete
+    for (; first_segment_ && info_read_ < LLC_SIZE && data_size > 0; --data_size) {
+      llc_[info_read_++] = *data++;
+    }
+    if (!overflow_) {
+      std::memcpy(&buffer_[write_pos_ + segment_size_], data, data_size);
+    }
+    segment_size_ += data_size;
+    info_read_ += data_size;
+    info_remaining_ -= size;
+    if (info_remaining_ == 0) {
+      state_ = State::FCS;
+    }
+    return pos + size;
+  }
+
+  HdlcEvent end_frame_(uint8_t byte) {
+    if (byte != FLAG) {
+      return invalid_frame_();
+    }
+    // The closing flag may also open the next frame
+    state_ = State::FORMAT;
+    header_size_ = 0;
+    if (!has_info_) {
+      return HdlcEvent::NONE;
+    }
+    if (fcs_.crc() != FCS16_GOOD) {
+      drop_message_();
+      return HdlcEvent::INVALID_FCS;
+    }
+    if (overflow_) {
+      drop_message_();
+      return HdlcEvent::BUFFER_OVERFLOW;
+    }
+    if (first_segment_ && (info_read_ < LLC_SIZE || llc_[0] != 0xE6 || (llc_[1] & 0xFE) != 0xE6 || llc_[2] != 0)) {
+      drop_message_();
+      return HdlcEvent::MISSING_SEGMENT;
+    }
+    if (!first_segment_ && sequenced_ && send_sequence_ != next_send_sequence_) {
+      drop_message_();
+      return HdlcEvent::MISSING_SEGMENT;
+    }
+    // The segment is only added to the message once it has been verified
+    write_pos_ += segment_size_;
+    next_send_sequence_ = (send_sequence_ + 1) & 0x07;
+    if (segmented_) {
+      in_message_ = true;
+      return HdlcEvent::NONE;
+    }
+    message_size_ = write_pos_;
+    in_message_ = false;
+    write_pos_ = 0;
+    return HdlcEvent::MESSAGE;
+  }
+
+  HdlcEvent invalid_frame_() {
+    state_ = State::SEARCH;
+    drop_message_();
+    return HdlcEvent::INVALID_FRAME;
+  }
+
+  void drop_message_() {
+    in_message_ = false;
+    write_pos_ = 0;
+    message_size_ = 0;
+  }
+
+  char *buffer_{nullptr};
+  size_t buffer_size_{0};
+  State state_{State::SEARCH};
+  Fcs16Calculator fcs_;
+  size_t header_size_{0};
+  size_t frame_size_{0};
+  size_t address_end_{0};
+  uint8_t addresses_found_{0};
+  bool segmented_{false};
+  bool sequenced_{false};
+  uint8_t send_sequence_{0};
+  uint8_t next_send_sequence_{0};
+  bool has_info_{false};
+  bool first_segment_{false};
+  bool in_message_{false};
+  bool overflow_{false};
+  uint8_t llc_[LLC_SIZE]{};
+  size_t info_remaining_{0};
+  size_t info_read_{0};
+  size_t segment_size_{0};
+  uint8_t fcs_bytes_read_{0};
+  size_t write_pos_{0};
+  size_t message_size_{0};
+};
+
+}  // namespace efs
+}  // namespace esphome
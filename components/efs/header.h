@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 
@@ -6,13 +7,79 @@
 
 namespace esphome {
 namespace efs {
+/// Layout of the parsed output.
+///
+/// PADDED objects start with an 8-byte Header, hold NUL-terminated values
+/// and are padded to 2 bytes, so the output must be 2-byte aligned.
+///
+/// COMPACT objects start with a flags byte, the OBIS code and the number of
+/// values, and each value is prefixed with its length as a varint. The A and
+/// B groups of the OBIS code are left out when they are the same as in the
+/// previous object (COMPACT_SHARED_PREFIX). The identification is stored as
+/// a single length prefixed value. There is no padding, no NUL terminators
+/// and no index.
+enum class Encoding : uint8_t { PADDED, COMPACT };
+
+/// Flag of a COMPACT object whose A and B groups are the same as in the previous object.
+const uint8_t COMPACT_SHARED_PREFIX = 0x01;
+/// Varints are at most 2 bytes, which covers values up to MAX_OBJECT_SIZE.
+const size_t MAX_VARINT_SIZE = 2;
+const size_t MAX_VARINT_VALUE = 0x3FFF;
+
 struct Header {
  public:
-  ObisCode obis_code;
+  uint8_t obis_code[5];  // Packed into ObisCode when read
   uint8_t num_values;
   uint16_t object_size;  // Size of the current obj. including Header
 };
 const size_t HEADER_SIZE = sizeof(Header);
 static_assert(HEADER_SIZE == 8, "Header size should be 8 bytes.");
+
+/// Entry of the optional index written after the objects, sorted by OBIS code.
+struct IndexEntry {
+ public:
+  uint8_t obis_code[5];
+  uint8_t reserved;
+  uint16_t offset;  // Offset of the object's Header from the start of the output, in units of 2 bytes
+};
+const size_t INDEX_ENTRY_SIZE = sizeof(IndexEntry);
+static_assert(INDEX_ENTRY_SIZE == 8, "Index entry size should be 8 bytes.");
+
+namespace util {
+/// Read the little endian base 128 varint at pos, which is advanced past it.
+///
+/// Returns false if the varint is longer than MAX_VARINT_SIZE or runs past end.
+inline bool read_varint(const char *&pos, const char *end, size_t &value) {
+  value = 0;
+  for (size_t i = 0; i < MAX_VARINT_SIZE && pos != end; ++i) {
+    const auto byte = static_cast<uint8_t>(*pos++);
+    value |= static_cast<size_t>(byte & 0x7F) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Write an index of the num_objects objects starting at objects to index, sorted by OBIS code.
+///
+/// Each entry is inserted in sorted order so that objects with the same OBIS
+/// code keep their order. The offsets are relative to buffer.
+inline void write_index(const char *buffer, const char *objects, size_t num_objects, IndexEntry *index) {
+  const char *pos = objects;
+  for (size_t i = 0; i < num_objects; ++i) {
+    const auto *header = reinterpret_cast<const Header *>(pos);
+    const auto obis_code = ObisCode::from_bytes(header->obis_code);
+    IndexEntry *const entry =
+        std::upper_bound(index, &index[i], obis_code, [](const ObisCode &lhs, const IndexEntry &rhs) {
+          return lhs < ObisCode::from_bytes(rhs.obis_code);
+        });
+    std::move_backward(entry, &index[i], &index[i + 1]);
+    *entry = IndexEntry{{}, 0, static_cast<uint16_t>((pos - buffer) / 2)};
+    obis_code.to_bytes(entry->obis_code);
+    pos += header->object_size;
+  }
+}
+}  // namespace util
 }  // namespace efs
 }  // namespace esphome
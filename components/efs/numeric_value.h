@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "scan.h"
+
+namespace esphome {
+namespace efs {
+
+enum class Unit : uint8_t {
+  NONE,
+  UNKNOWN,
+  WH,
+  KWH,
+  VARH,
+  KVARH,
+  VAH,
+  KVAH,
+  W,
+  KW,
+  VAR,
+  KVAR,
+  VA,
+  KVA,
+  V,
+  A,
+  M3,
+  GJ,
+  S,
+  HZ,
+};
+
+/// A decimal number with a unit, the value is mantissa * 10^scale.
+struct NumericValue {
+  int64_t mantissa;
+  int8_t scale;
+  Unit unit;
+
+  /// Convert the value to its kilo unit, e.g. Wh to kWh, by adjusting the scale.
+  NumericValue normalized() const {
+    switch (unit) {
+      case Unit::WH:
+        return {mantissa, static_cast<int8_t>(scale - 3), Unit::KWH};
+      case Unit::VARH:
+        return {mantissa, static_cast<int8_t>(scale - 3), Unit::KVARH};
+      case Unit::VAH:
+        return {mantissa, static_cast<int8_t>(scale - 3), Unit::KVAH};
+      case Unit::W:
+        return {mantissa, static_cast<int8_t>(scale - 3), Unit::KW};
+      case Unit::VAR:
+        return {mantissa, static_cast<int8_t>(scale - 3), Unit::KVAR};
+      case Unit::VA:
+        return {mantissa, static_cast<int8_t>(scale - 3), Unit::KVA};
+      default:
+        return *this;
+    }
+  }
+
+  /// Convert the value to an integer in units of 10^scale, e.g. scale -3 gives milli units.
+  ///
+  /// The conversion is exact unless the requested scale has fewer decimals
+  /// than the value, in which case it is rounded half away from zero. Returns
+  /// std::nullopt if the result does not fit in an int64_t.
+  std::optional<int64_t> to_fixed_point(int8_t target_scale) const;
+
+  /// Round the value to decimals decimals and convert it to a float.
+  ///
+  /// The rounding is done on the exact value, only the final conversion to a
+  /// float is inexact. Returns std::nullopt if the value is out of range.
+  std::optional<float> to_float(int8_t decimals) const;
+
+  /// Convert the value to a float without rounding it first.
+  float to_float() const;
+};
+
+namespace util {
+constexpr std::array<int64_t, 19> init_powers_of_ten() {
+  std::array<int64_t, 19> powers = {1};
+  for (size_t i = 1; i < powers.size(); ++i) {
+    powers[i] = powers[i - 1] * 10;
+  }
+  return powers;
+}
+
+constexpr std::array<int64_t, 19> POWERS_OF_TEN = init_powers_of_ten();
+
+inline float fixed_point_to_float(int64_t value, int8_t scale) {
+  if (scale >= 0) {
+    return static_cast<float>(static_cast<double>(value) * static_cast<double>(POWERS_OF_TEN[scale]));
+  }
+  return static_cast<float>(static_cast<double>(value) / static_cast<double>(POWERS_OF_TEN[-scale]));
+}
+}  // namespace util
+
+inline std::optional<int64_t> NumericValue::to_fixed_point(int8_t target_scale) const {
+  const int shift = scale - target_scale;
+  if (shift >= 0) {
+    if (mantissa == 0) {
+      return 0;
+    }
+    if (shift >= static_cast<int>(util::POWERS_OF_TEN.size())) {
+      return std::nullopt;
+    }
+    const int64_t factor = util::POWERS_OF_TEN[shift];
+    if (mantissa > INT64_MAX / factor || mantissa < INT64_MIN / factor) {
+      return std::nullopt;
+    }
+    return mantissa * factor;
+  }
+  if (-shift >= static_cast<int>(util::POWERS_OF_TEN.size())) {
+    return 0;
+  }
+  const int64_t divisor = util::POWERS_OF_TEN[-shift];
+  const int64_t quotient = mantissa / divisor;
+  const int64_t remainder = mantissa % divisor;
+  // Round half away from zero, comparing without overflowing
+  if (remainder >= divisor - remainder) {
+    return quotient + 1;
+  }
+  if (-remainder >= divisor + remainder) {
+    return quotient - 1;
+  }
+  return quotient;
+}
+
+inline std::optional<float> NumericValue::to_float(int8_t decimals) const {
+  if (decimals < -18 || decimals > 18) {
+    return std::nullopt;
+  }
+  const auto target_scale = static_cast<int8_t>(-decimals);
+  const auto value = to_fixed_point(target_scale);
+  if (!value.has_value()) {
+    return std::nullopt;
+  }
+  return util::fixed_point_to_float(*value, target_scale);
+}
+
+inline float NumericValue::to_float() const {
+  if (scale < -18) {
+    return 0.0f;
+  }
+  return to_float(std::max<int8_t>(-scale, 0)).value_or(0.0f);
+}
+
+namespace util {
+struct UnitName {
+  const char *name;
+  Unit unit;
+};
+
+constexpr std::array<UnitName, 18> UNIT_NAMES{{
+    {"Wh", Unit::WH},    {"kWh", Unit::KWH}, {"varh", Unit::VARH}, {"kvarh", Unit::KVARH}, {"VAh", Unit::VAH},
+    {"kVAh", Unit::KVAH}, {"W", Unit::W},     {"kW", Unit::KW},     {"var", Unit::VAR},     {"kvar", Unit::KVAR},
+    {"VA", Unit::VA},    {"kVA", Unit::KVA}, {"V", Unit::V},       {"A", Unit::A},         {"m3", Unit::M3},
+    {"GJ", Unit::GJ},    {"s", Unit::S},     {"Hz", Unit::HZ},
+}};
+
+/// Get the name of unit as written in telegrams, or nullptr for Unit::NONE and Unit::UNKNOWN.
+constexpr const char *unit_name(Unit unit) {
+  for (const auto &unit_name : UNIT_NAMES) {
+    if (unit_name.unit == unit) {
+      return unit_name.name;
+    }
+  }
+  return nullptr;
+}
+
+constexpr char to_lower(char ch) { return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch; }
+
+/// Look up a unit by name, ignoring case since meters differ in e.g. kvarh/kVArh.
+constexpr Unit parse_unit(const char *name, size_t size) {
+  if (size == 0) {
+    return Unit::NONE;
+  }
+  for (const auto &unit_name : UNIT_NAMES) {
+    size_t i = 0;
+    for (; i < size && unit_name.name[i] != '\0'; ++i) {
+      if (to_lower(name[i]) != to_lower(unit_name.name[i])) {
+        break;
+      }
+    }
+    if (i == size && unit_name.name[i] == '\0') {
+      return unit_name.unit;
+    }
+  }
+  return Unit::UNKNOWN;
+}
+}  // namespace util
+
+/// Parse a value on the format [-]digits[.digits][*unit], e.g. "123456.789*kWh".
+///
+/// Only integer arithmetic is used so the decimal value is represented
+/// exactly. Returns false if the value is not a number or has too many
+/// digits to be represented.
+inline bool parse_numeric(const char *data, size_t size, NumericValue &value) {
+  const char *pos = data;
+  const char *const end = &data[size];
+  const bool negative = pos != end && *pos == '-';
+  if (pos != end && (*pos == '-' || *pos == '+')) {
+    ++pos;
+  }
+  uint64_t mantissa = 0;
+  int8_t scale = 0;
+  size_t num_digits = 0;
+  bool has_digits = false;
+  bool decimal_point = false;
+  for (; pos != end && *pos != '*'; ++pos) {
+    if (util::is_digit(*pos)) {
+      const uint8_t digit = *pos - '0';
+      // 18 significant digits always fit in an int64_t
+      if ((mantissa != 0 || digit != 0) && ++num_digits > 18) {
+        return false;
+      }
+      mantissa = mantissa * 10 + digit;
+      has_digits = true;
+      if (decimal_point) {
+        if (scale == INT8_MIN) {
+          return false;
+        }
+        --scale;
+      }
+    } else if (*pos == '.' && !decimal_point) {
+      decimal_point = true;
+    } else {
+      return false;
+    }
+  }
+  if (!has_digits) {
+    return false;
+  }
+  Unit unit = Unit::NONE;
+  if (pos != end) {
+    ++pos;
+    unit = util::parse_unit(pos, end - pos);
+  }
+  value = NumericValue{negative ? -static_cast<int64_t>(mantissa) : static_cast<int64_t>(mantissa), scale, unit};
+  return true;
+}
+
+}  // namespace efs
+}  // namespace esphome
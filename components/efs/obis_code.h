@@ -1,53 +1,123 @@
 #pragma once
-#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 
 namespace esphome {
 namespace efs {
+/// A five part OBIS code A-B:C.D.E, packed into an integer so that it is
+/// compared, sorted and hashed as a single word.
 class ObisCode {
  public:
-  ObisCode(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint8_t e) : value_{a, b, c, d, e} {};
-  uint8_t &operator[](size_t pos) { return value_[pos]; }
-  const uint8_t &operator[](size_t pos) const { return value_[pos]; }
-  friend bool operator==(const ObisCode &lhs, const ObisCode &rhs) { return lhs.value_ == rhs.value_; }
-  friend bool operator<(const ObisCode &lhs, const ObisCode &rhs) { return lhs.value_ < rhs.value_; }
+  constexpr ObisCode(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint8_t e)
+      : key_{static_cast<uint64_t>(a) << 32 | static_cast<uint64_t>(b) << 24 | static_cast<uint64_t>(c) << 16 |
+             static_cast<uint64_t>(d) << 8 | static_cast<uint64_t>(e)} {}
+
+  /// Create an OBIS code from its key, the parts packed as A << 32 | B << 24 | C << 16 | D << 8 | E.
+  static constexpr ObisCode from_key(uint64_t key) { return ObisCode(key & 0xFFFFFFFFFF); }
+  /// Create an OBIS code from its five parts stored as bytes.
+  static constexpr ObisCode from_bytes(const uint8_t *bytes) {
+    return ObisCode(bytes[0], bytes[1], bytes[2], bytes[3], bytes[4]);
+  }
+
+  /// Store the five parts as bytes.
+  constexpr void to_bytes(uint8_t *bytes) const {
+    for (size_t pos = 0; pos < 5; ++pos) {
+      bytes[pos] = (*this)[pos];
+    }
+  }
+
+  constexpr uint64_t key() const { return key_; }
+  constexpr uint8_t operator[](size_t pos) const { return static_cast<uint8_t>(key_ >> (8 * (4 - pos))); }
+  friend constexpr bool operator==(const ObisCode &lhs, const ObisCode &rhs) { return lhs.key_ == rhs.key_; }
+  friend constexpr bool operator!=(const ObisCode &lhs, const ObisCode &rhs) { return lhs.key_ != rhs.key_; }
+  friend constexpr bool operator<(const ObisCode &lhs, const ObisCode &rhs) { return lhs.key_ < rhs.key_; }
 
  protected:
-  std::array<uint8_t, 5> value_;
+  explicit constexpr ObisCode(uint64_t key) : key_{key} {}
+
+  uint64_t key_;
 };
 
-const ObisCode ENERGY_IMPORTED(1, 0, 1, 8, 0);
-const ObisCode ENERGY_IMPORTED_TARIFF1(1, 0, 1, 8, 1);
-const ObisCode ENERGY_IMPORTED_TARIFF2(1, 0, 1, 8, 2);
-const ObisCode ENERGY_EXPORTED(1, 0, 2, 8, 0);
-const ObisCode ENERGY_EXPORTED_TARIFF1(1, 0, 2, 8, 1);
-const ObisCode ENERGY_EXPORTED_TARIFF2(1, 0, 2, 8, 2);
-const ObisCode REACTIVE_ENERGY_IMPORTED(1, 0, 3, 8, 0);
-const ObisCode REACTIVE_ENERGY_EXPORTED(1, 0, 4, 8, 0);
-const ObisCode POWER_IMPORTED(1, 0, 1, 7, 0);
-const ObisCode POWER_EXPORTED(1, 0, 2, 7, 0);
-const ObisCode REACTIVE_POWER_IMPORTED(1, 0, 3, 7, 0);
-const ObisCode REACTIVE_POWER_EXPORTED(1, 0, 4, 7, 0);
-const ObisCode POWER_IMPORTED_L1(1, 0, 21, 7, 0);
-const ObisCode POWER_EXPORTED_L1(1, 0, 22, 7, 0);
-const ObisCode POWER_IMPORTED_L2(1, 0, 41, 7, 0);
-const ObisCode POWER_EXPORTED_L2(1, 0, 42, 7, 0);
-const ObisCode POWER_IMPORTED_L3(1, 0, 61, 7, 0);
-const ObisCode POWER_EXPORTED_L3(1, 0, 62, 7, 0);
-const ObisCode REACTIVE_POWER_IMPORTED_L1(1, 0, 23, 7, 0);
-const ObisCode REACTIVE_POWER_EXPORTED_L1(1, 0, 24, 7, 0);
-const ObisCode REACTIVE_POWER_IMPORTED_L2(1, 0, 43, 7, 0);
-const ObisCode REACTIVE_POWER_EXPORTED_L2(1, 0, 44, 7, 0);
-const ObisCode REACTIVE_POWER_IMPORTED_L3(1, 0, 63, 7, 0);
-const ObisCode REACTIVE_POWER_EXPORTED_L3(1, 0, 64, 7, 0);
-const ObisCode VOLTAGE_L1(1, 0, 32, 7, 0);
-const ObisCode VOLTAGE_L2(1, 0, 52, 7, 0);
-const ObisCode VOLTAGE_L3(1, 0, 72, 7, 0);
-const ObisCode CURRENT_L1(1, 0, 31, 7, 0);
-const ObisCode CURRENT_L2(1, 0, 51, 7, 0);
-const ObisCode CURRENT_L3(1, 0, 71, 7, 0);
-const ObisCode CT_RATIO(1, 0, 1, 4, 2);
-const ObisCode VT_RATIO(1, 0, 1, 4, 3);
+namespace util {
+// Not constexpr, calling it while evaluating a constant expression fails the compilation.
+inline void invalid_obis_code() {}
+
+constexpr ObisCode parse_obis_code(const char *str, size_t size) {
+  uint64_t key = 0;
+  size_t part = 0;
+  size_t pos = 0;
+  while (part < 5) {
+    uint16_t value = 0;
+    size_t num_digits = 0;
+    for (; pos < size && str[pos] >= '0' && str[pos] <= '9'; ++pos, ++num_digits) {
+      value = value * 10 + (str[pos] - '0');
+    }
+    constexpr char SEPARATORS[] = {'-', ':', '.', '.', '\0'};
+    const char separator = pos < size ? str[pos] : '\0';
+    if (num_digits == 0 || num_digits > 3 || value > 255 || separator != SEPARATORS[part]) {
+      invalid_obis_code();
+      return ObisCode(0, 0, 0, 0, 0);
+    }
+    key = key << 8 | value;
+    ++part;
+    ++pos;
+  }
+  return ObisCode::from_key(key);
+}
+}  // namespace util
+
+#ifdef __cpp_consteval
+#define EFS_OBIS_LITERAL consteval
+#else
+#define EFS_OBIS_LITERAL constexpr
+#endif
+
+/// An OBIS code on the format A-B:C.D.E, e.g. "1-0:1.8.0"_obis.
+///
+/// Invalid codes fail to compile. Before C++20 the literal can not be forced
+/// to be evaluated at compile time, so this only holds when it is used in a
+/// constant expression, e.g. to initialize a constexpr variable. Use
+/// util::parse_obis_code() for codes that are only known at runtime.
+EFS_OBIS_LITERAL ObisCode operator""_obis(const char *str, size_t size) { return util::parse_obis_code(str, size); }
+
+constexpr ObisCode ENERGY_IMPORTED(1, 0, 1, 8, 0);
+constexpr ObisCode ENERGY_IMPORTED_TARIFF1(1, 0, 1, 8, 1);
+constexpr ObisCode ENERGY_IMPORTED_TARIFF2(1, 0, 1, 8, 2);
+constexpr ObisCode ENERGY_EXPORTED(1, 0, 2, 8, 0);
+constexpr ObisCode ENERGY_EXPORTED_TARIFF1(1, 0, 2, 8, 1);
+constexpr ObisCode ENERGY_EXPORTED_TARIFF2(1, 0, 2, 8, 2);
+constexpr ObisCode REACTIVE_ENERGY_IMPORTED(1, 0, 3, 8, 0);
+constexpr ObisCode REACTIVE_ENERGY_EXPORTED(1, 0, 4, 8, 0);
+constexpr ObisCode POWER_IMPORTED(1, 0, 1, 7, 0);
+constexpr ObisCode POWER_EXPORTED(1, 0, 2, 7, 0);
+constexpr ObisCode REACTIVE_POWER_IMPORTED(1, 0, 3, 7, 0);
+constexpr ObisCode REACTIVE_POWER_EXPORTED(1, 0, 4, 7, 0);
+constexpr ObisCode POWER_IMPORTED_L1(1, 0, 21, 7, 0);
+constexpr ObisCode POWER_EXPORTED_L1(1, 0, 22, 7, 0);
+constexpr ObisCode POWER_IMPORTED_L2(1, 0, 41, 7, 0);
+constexpr ObisCode POWER_EXPORTED_L2(1, 0, 42, 7, 0);
+constexpr ObisCode POWER_IMPORTED_L3(1, 0, 61, 7, 0);
+constexpr ObisCode POWER_EXPORTED_L3(1, 0, 62, 7, 0);
+constexpr ObisCode REACTIVE_POWER_IMPORTED_L1(1, 0, 23, 7, 0);
+constexpr ObisCode REACTIVE_POWER_EXPORTED_L1(1, 0, 24, 7, 0);
+constexpr ObisCode REACTIVE_POWER_IMPORTED_L2(1, 0, 43, 7, 0);
+constexpr ObisCode REACTIVE_POWER_EXPORTED_L2(1, 0, 44, 7, 0);
+constexpr ObisCode REACTIVE_POWER_IMPORTED_L3(1, 0, 63, 7, 0);
+constexpr ObisCode REACTIVE_POWER_EXPORTED_L3(1, 0, 64, 7, 0);
+constexpr ObisCode VOLTAGE_L1(1, 0, 32, 7, 0);
+constexpr ObisCode VOLTAGE_L2(1, 0, 52, 7, 0);
+constexpr ObisCode VOLTAGE_L3(1, 0, 72, 7, 0);
+constexpr ObisCode CURRENT_L1(1, 0, 31, 7, 0);
+constexpr ObisCode CURRENT_L2(1, 0, 51, 7, 0);
+constexpr ObisCode CURRENT_L3(1, 0, 71, 7, 0);
+constexpr ObisCode CT_RATIO(1, 0, 1, 4, 2);
+constexpr ObisCode VT_RATIO(1, 0, 1, 4, 3);
 }  // namespace efs
 }  // namespace esphome
+
+namespace std {
+template<> struct hash<esphome::efs::ObisCode> {
+  size_t operator()(const esphome::efs::ObisCode &obis_code) const { return hash<uint64_t>{}(obis_code.key()); }
+};
+}  // namespace std
@@ -1,7 +1,11 @@
 #pragma once
+#include <cstdint>
+#include <optional>
 #include <string_view>
 
+#include "numeric_value.h"
 #include "obis_code.h"
+#include "timestamp.h"
 #include "value_iterator.h"
 
 namespace esphome {
@@ -12,22 +16,66 @@ class Object {
   using value_type = ValueIterator::value_type;
   using const_iterator = ValueIterator;
 
-  Object(ObisCode obis_code, uint8_t num_values, std::string_view data)
-      : obis_code_{obis_code}, num_values_{num_values}, data_{data} {}
+  Object(ObisCode obis_code, uint8_t num_values, std::string_view data, Encoding encoding = Encoding::PADDED)
+      : obis_code_{obis_code}, num_values_{num_values}, encoding_{encoding}, data_{data} {}
   Object(Object &&other) = default;
   Object &operator=(Object &&other) = default;
 
   const ObisCode &obis_code() const { return obis_code_; }
   uint8_t num_values() const { return num_values_; }
   const std::string_view &data() const { return data_; }
+  Encoding encoding() const { return encoding_; }
 
-  const_iterator begin() const { return const_iterator(data_.data(), data_.size(), num_values_); }
+  const_iterator begin() const { return const_iterator(data_.data(), data_.size(), num_values_, encoding_); }
 
   const_iterator end() const { return const_iterator(); }
 
+  /// Get a 32-bit FNV-1a hash of the value bytes, to detect values that are unchanged since a previous telegram.
+  uint32_t fingerprint() const {
+    uint32_t hash = 2166136261u;
+    for (const char ch : data_) {
+      hash = (hash ^ static_cast<uint8_t>(ch)) * 16777619u;
+    }
+    return hash;
+  }
+
+  /// Get an iterator to the value at index, or end() if there is no such value.
+  const_iterator value_at(uint8_t index) const {
+    auto it = begin();
+    for (uint8_t i = 0; i < index && it != end(); ++i) {
+      ++it;
+    }
+    return it;
+  }
+
+  /// Decode the value at index as a number with a unit, e.g. "123456.789*kWh".
+  ///
+  /// Returns std::nullopt if there is no such value or if it is not numeric.
+  std::optional<NumericValue> numeric(uint8_t index = 0) const {
+    const auto it = value_at(index);
+    NumericValue value;
+    if (it == end() || !parse_numeric(std::get<0>(*it), std::get<1>(*it), value)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  /// Decode the value at index as a timestamp, e.g. "101209113020W".
+  ///
+  /// Returns std::nullopt if there is no such value or if it is not a timestamp.
+  std::optional<Timestamp> timestamp(uint8_t index = 0) const {
+    const auto it = value_at(index);
+    Timestamp value;
+    if (it == end() || !parse_timestamp(std::get<0>(*it), std::get<1>(*it), value)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
  private:
   ObisCode obis_code_;
   uint8_t num_values_;
+  Encoding encoding_;
   std::string_view data_;
 };
 
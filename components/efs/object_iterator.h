@@ -18,12 +18,17 @@ class ObjectIterator {
   using reference = const Object &;
 
   ObjectIterator()
-      : buffer_(nullptr), buffer_end_(nullptr), num_objects_(0), current_{{0, 0, 0, 0, 0}, 0, std::string_view()} {};
+      : buffer_(nullptr),
+        buffer_end_(nullptr),
+        num_objects_(0),
+        encoding_(Encoding::PADDED),
+        current_{{0, 0, 0, 0, 0}, 0, std::string_view()} {};
 
-  ObjectIterator(const char *buffer, size_t buffer_size)
+  ObjectIterator(const char *buffer, size_t buffer_size, Encoding encoding = Encoding::PADDED)
       : buffer_(buffer),
         buffer_end_(buffer + buffer_size),
         num_objects_(0),
+        encoding_(encoding),
         current_{{0, 0, 0, 0, 0}, 0, std::string_view()} {
     if (buffer_ == nullptr || buffer_size == 0) {
       buffer_ = nullptr;
@@ -31,6 +36,21 @@ class ObjectIterator {
     }
 
     // Handle identification string
+    if (encoding_ == Encoding::COMPACT) {
+      const char *identification = buffer_;
+      size_t identification_size;
+      if (!util::read_varint(identification, buffer_end_, identification_size) ||
+          identification_size >= static_cast<size_t>(buffer_end_ - identification)) {
+        buffer_ = nullptr;
+        return;
+      }
+      identification_size += identification - buffer_;
+      current_ = Object{ObisCode(0, 0, 0, 0, 0), 1, std::string_view(buffer_, identification_size), encoding_};
+      buffer_ += identification_size;
+      num_objects_ = *reinterpret_cast<const uint8_t *>(buffer_);
+      ++buffer_;
+      return;
+    }
     const auto identification_size = strnlen(buffer_, buffer_size) + 1;
     current_ = Object{ObisCode(0, 0, 0, 0, 0), 1, std::string_view(buffer_, identification_size)};
     buffer_ += identification_size;
@@ -49,6 +69,10 @@ class ObjectIterator {
   pointer operator->() const { return &current_; }
 
   ObjectIterator &operator++() {
+    if (encoding_ == Encoding::COMPACT) {
+      next_compact_();
+      return *this;
+    }
     if (buffer_ == nullptr || num_objects_ == 0 || buffer_end_ - buffer_ <= static_cast<ptrdiff_t>(HEADER_SIZE)) {
       buffer_ = nullptr;
       return *this;
@@ -60,7 +84,7 @@ class ObjectIterator {
       return *this;
     }
 
-    current_ = Object{header->obis_code, header->num_values,
+    current_ = Object{ObisCode::from_bytes(header->obis_code), header->num_values,
                       std::string_view(&buffer_[HEADER_SIZE], header->object_size - HEADER_SIZE)};
     buffer_ += header->object_size;
     --num_objects_;
@@ -73,9 +97,47 @@ class ObjectIterator {
   bool operator!=(const ObjectIterator &other) const { return !(*this == other); }
 
  private:
+  // Read the flags, OBIS code and number of values of the next object, then walk the length prefixes of its values to
+  // find where it ends.
+  void next_compact_() {
+    if (buffer_ == nullptr || num_objects_ == 0 || buffer_end_ - buffer_ < 5) {
+      buffer_ = nullptr;
+      return;
+    }
+    const auto *pos = reinterpret_cast<const uint8_t *>(buffer_);
+    const bool shared_prefix = (*pos++ & COMPACT_SHARED_PREFIX) != 0;
+    if (!shared_prefix) {
+      if (buffer_end_ - buffer_ < 7) {
+        buffer_ = nullptr;
+        return;
+      }
+      prefix_[0] = *pos++;
+      prefix_[1] = *pos++;
+    }
+    const ObisCode obis_code(prefix_[0], prefix_[1], pos[0], pos[1], pos[2]);
+    const uint8_t num_values = pos[3];
+    const char *const values = reinterpret_cast<const char *>(&pos[4]);
+    const char *values_end = values;
+    for (uint8_t i = 0; i < num_values; ++i) {
+      size_t value_size;
+      if (!util::read_varint(values_end, buffer_end_, value_size) ||
+          value_size > static_cast<size_t>(buffer_end_ - values_end)) {
+        buffer_ = nullptr;
+        return;
+      }
+      values_end += value_size;
+    }
+    current_ = Object{obis_code, num_values, std::string_view(values, values_end - values), encoding_};
+    buffer_ = values_end;
+    --num_objects_;
+  }
+
   const char *buffer_;
   const char *buffer_end_;
   uint8_t num_objects_;
+  Encoding encoding_;
+  // The A and B groups of the previous compact object
+  uint8_t prefix_[2]{};
   Object current_;
 };
 
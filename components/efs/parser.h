@@ -1,11 +1,14 @@
 #pragma once
-#include <cctype>
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "crc16.h"
 #include "header.h"
 #include "obis_code.h"
+#include "scan.h"
 #include "status.h"
 #include "result.h"
 
@@ -14,67 +17,130 @@ namespace efs {
 const uint32_t MAX_OBJECT_SIZE = 8192;
 const uint32_t MAX_HEADER_SIZE = 256;
 const uint32_t MAX_NUM_OBJECTS = 255;
+const uint32_t MAX_NUM_VALUES = 255;
+static_assert(MAX_OBJECT_SIZE <= MAX_VARINT_VALUE, "The values of a compact object must fit in a 2-byte varint.");
 
 template<typename CrcCalculator> class BaseParser {
  public:
+  /// Parse a complete telegram in place, i.e. the parsed output overwrites the telegram in the buffer.
   Result parse_telegram(char *buffer, size_t buffer_size) {
-    reset_state_(buffer, buffer_size);
-    if (reinterpret_cast<uintptr_t>(buffer) % 2 != 0) {
-      return Result(Status::BUFFER_NOT_ALIGNED, nullptr, 0);
-    }
-    read_header_();
-    if (status_ != Status::OK) {
-      return Result(status_, nullptr, 0);
-    }
-    uint8_t *num_objects = write_<uint8_t>(0);
-    if ((write_pos_ - buffer) % 2 != 0) {
-      // Add padding to align header to 2 bytes
-      write_('\0');
+    begin(buffer, buffer_size);
+    in_place_ = true;
+    feed(buffer, buffer_size);
+    return finish();
+  }
+
+  /// Only output the objects whose OBIS codes are in the sorted array codes.
+  ///
+  /// Other objects are only included in the checksum calculation, nothing is
+  /// written to the output for them. The codes are looked up with a binary
+  /// search, so they must be sorted in ascending order, and the array must
+  /// remain valid while the filter is in use. Passing nullptr disables the filter.
+  void set_filter(const ObisCode *codes, size_t num_codes) {
+    assert(codes == nullptr || std::is_sorted(codes, codes + num_codes));
+    filter_ = codes;
+    filter_end_ = codes == nullptr ? nullptr : &codes[num_codes];
+  }
+
+  /// Append a sorted index of the objects to the output, which Result::find() uses for a binary search.
+  ///
+  /// The index takes 8 bytes per object. It is omitted if it does not fit in
+  /// the buffer, in which case Result::find() searches the objects in order.
+  void set_index(bool enabled) { index_enabled_ = enabled; }
+
+  /// Write the output in encoding, see Encoding.
+  ///
+  /// Encoding::COMPACT output is smaller and needs no alignment, which lets
+  /// large telegrams fit in smaller buffers. No index is written for it.
+  void set_encoding(Encoding encoding) { encoding_ = encoding; }
+
+  /// Start parsing a new telegram incrementally, writing the parsed output to buffer.
+  ///
+  /// The telegram is then passed to feed() in chunks of any size as it is
+  /// received. The parser carries its state between the calls and writes each
+  /// object to the buffer as soon as its line is complete, so that only the
+  /// last line remains to be processed when finish() is called.
+  Status begin(char *buffer, size_t buffer_size) {
+    buffer_ = write_pos_ = buffer;
+    buffer_end_ = &buffer[buffer_size];
+    read_pos_ = crc_pos_ = nullptr;
+    in_place_ = false;
+    state_ = State::START;
+    status_ = Status::OK;
+    identification_read_ = false;
+    num_objects_ = nullptr;
+    object_ = nullptr;
+    num_values_ = nullptr;
+    value_ = nullptr;
+    has_prefix_ = false;
+    skip_object_ = false;
+    crc_calculator_.reset();
+    if (encoding_ == Encoding::PADDED && reinterpret_cast<uintptr_t>(buffer) % 2 != 0) {
+      status_ = Status::BUFFER_NOT_ALIGNED;
     }
-    while (status_ == Status::OK) {
-      next_char_();
-      if (eod_) {
-        break;
-      } else if (std::isspace(ch_) != 0) {
-        continue;
-      } else if (ch_ == '!') {
-        // CRC-16 checksum marker
-        uint16_t crc = read_crc_();
-        if (crc != crc_calculator_.crc()) {
-          status_ = Status::CRC_CHECK_FAILED;
-        }
-      } else if (std::isdigit(ch_) != 0) {
-        // OBIS code
-        if (*num_objects == MAX_NUM_OBJECTS) {
-          status_ = Status::TOO_MANY_OBJECTS;
-        } else {
-          read_object_();
-          ++(*num_objects);
+    return status_;
+  }
+
+  /// Parse the next chunk of the telegram.
+  Status feed(const char *chunk, size_t chunk_size) {
+    read_pos_ = crc_pos_ = chunk;
+    const char *const chunk_end = &chunk[chunk_size];
+    while (read_pos_ != chunk_end && state_ != State::DONE && status_ == Status::OK) {
+      if (read_pos_ == crc_pos_ && state_ != State::CRC) {
+        update_crc_(chunk_end);
+      }
+      if (state_ == State::VALUE) {
+        read_value_();
+        if (read_pos_ == crc_pos_ || status_ != Status::OK) {
+          continue;
         }
+      }
+      const char ch = *read_pos_++;
+      if (ch == '\0') {
+        end_of_data_();
       } else {
-        status_ = Status::PARSING_FAILED;
+        process_char_(ch);
       }
     }
-    return Result(status_, buffer, write_pos_ - buffer);
+    return status_;
   }
 
- protected:
-  const char &next_char_(bool update_crc = true) {
-    eod_ |= read_pos_ == buffer_end_;
-    if (!eod_) {
-      ch_ = *read_pos_++;
-      if (update_crc) {
-        crc_calculator_.update(ch_);
+  /// Finish parsing the telegram, treating the end of the fed data as the end of the telegram.
+  Result finish() {
+    if (state_ != State::DONE) {
+      end_of_data_();
+    }
+    if (!identification_read_) {
+      return Result(status_, nullptr, 0);
+    }
+    const size_t size = write_pos_ - buffer_;
+    if (index_enabled_ && encoding_ == Encoding::PADDED && status_ == Status::OK) {
+      const IndexEntry *index = write_index_();
+      if (index != nullptr) {
+        return Result(status_, buffer_, size, index, *num_objects_);
       }
-      eod_ = ch_ == '\0';
-    } else {
-      ch_ = '\0';
     }
-    return ch_;
+    return Result(status_, buffer_, size, encoding_);
   }
 
+ protected:
+  enum class State : uint8_t {
+    START,
+    IDENTIFICATION,
+    IDENTIFICATION_END,
+    BODY,
+    OBIS_CODE,
+    OBJECT,
+    VALUE,
+    OBJECT_END,
+    LINE_END,
+    CRC,
+    DONE,
+  };
+
   template<typename T> T *write_(const T &val) {
-    if ((read_pos_ - write_pos_) < static_cast<ptrdiff_t>(sizeof(T))) {
+    const char *const write_end = in_place_ ? read_pos_ : buffer_end_;
+    if ((write_end - write_pos_) < static_cast<ptrdiff_t>(sizeof(T))) {
       status_ = Status::WRITE_OVERFLOW;
       return nullptr;
     }
@@ -84,133 +150,404 @@ template<typename CrcCalculator> class BaseParser {
     return item_pos;
   }
 
-  void reset_state_(char *buffer, size_t buffer_size) {
-    read_pos_ = write_pos_ = buffer;
-    buffer_end_ = &buffer[buffer_size];
-    status_ = Status::OK;
-    crc_calculator_.reset();
-    eod_ = buffer_size == 0;
-  }
-
-  void read_header_() {
-    if (next_char_() != '/') {
-      status_ = Status::START_NOT_FOUND;
+  void write_(const char *data, size_t size) {
+    const char *const write_end = in_place_ ? read_pos_ : buffer_end_;
+    if ((write_end - write_pos_) < static_cast<ptrdiff_t>(size)) {
+      status_ = Status::WRITE_OVERFLOW;
       return;
     }
-    const char *const start = write_pos_;
-    do {
-      if (next_char_() == eod_) {
-        status_ = Status::PARSING_FAILED;
-      } else if (ch_ == '\r') {
-        if (next_char_() != '\n') {
-          status_ = Status::PARSING_FAILED;
+    // The value may overlap its destination when parsing in place
+    std::memmove(write_pos_, data, size);
+    write_pos_ += size;
+  }
+
+  void process_char_(char ch) {
+    switch (state_) {
+      case State::START:
+        if (ch == '/') {
+          if (encoding_ == Encoding::COMPACT) {
+            start_compact_value_();
+          }
+          state_ = State::IDENTIFICATION;
+        } else {
+          status_ = Status::START_NOT_FOUND;
         }
-        write_('\0');
-        if (write_pos_ - start > MAX_HEADER_SIZE) {
-          status_ = Status::HEADER_TOO_LONG;
+        break;
+      case State::IDENTIFICATION:
+        if (ch == '\r') {
+          state_ = State::IDENTIFICATION_END;
+        } else {
+          write_(ch);
         }
         break;
-      } else {
-        write_(ch_);
-      }
-    } while (status_ == Status::OK);
-  }
-
-  ObisCode read_obis_code_() {
-    size_t part = 0;
-    uint8_t cur = 0;
-    ObisCode obis_code{0, 0, 0, 0, 0};
-    while (status_ == Status::OK) {
-      if (std::isdigit(ch_) != 0) {
-        const uint8_t val = ch_ - '0';
-        if (cur > 25 || (cur == 25 && val > 5)) {
-          status_ = Status::INVALID_OBIS_CODE;
-          break;
+      case State::IDENTIFICATION_END:
+        read_identification_end_(ch);
+        break;
+      case State::BODY:
+        read_body_(ch);
+        break;
+      case State::OBIS_CODE:
+        read_obis_code_(ch);
+        break;
+      case State::OBJECT:
+        read_object_(ch);
+        break;
+      case State::VALUE:
+        if (ch == ')') {
+          if (encoding_ == Encoding::COMPACT && !skip_object_) {
+            end_compact_value_();
+          } else if (!skip_object_) {
+            write_('\0');
+          }
+          state_ = State::OBJECT;
+        } else if (!skip_object_) {
+          write_(ch);
         }
-        cur = cur * 10 + val;
-      } else if ((ch_ == '-' || ch_ == ':' || ch_ == '.' || ch_ == '*') && part <= 4) {
-        obis_code[part] = cur;
-        cur = 0;
-        ++part;
-      } else {
-        // The final part of the obis code is usually omitted
-        if (part == 4) {
-          obis_code[4] = cur;
-        } else if (part != 5 || (part == 5 && cur != 255)) {
-          // Reading 6-part obis codes is supported but the 6th part must be 255
-          // since only 5 parts are stored.
-          status_ = Status::INVALID_OBIS_CODE;
+        break;
+      case State::OBJECT_END:
+        if (ch == '\n') {
+          state_ = State::LINE_END;
+        } else {
+          status_ = Status::PARSING_FAILED;
         }
         break;
+      case State::LINE_END:
+        read_line_end_(ch);
+        break;
+      case State::CRC:
+        read_crc_(ch);
+        break;
+      case State::DONE:
+        break;
+    }
+  }
+
+  // Update the checksum with the run of bytes up to and including the next
+  // potential checksum marker. This runs ahead of the parser, since an in
+  // place parse overwrites the bytes that it has read.
+  void update_crc_(const char *chunk_end) {
+    const auto *marker = static_cast<const char *>(std::memchr(crc_pos_, '!', chunk_end - crc_pos_));
+    const char *const end = marker == nullptr ? chunk_end : marker + 1;
+    crc_calculator_.update(crc_pos_, end - crc_pos_);
+    crc_pos_ = end;
+  }
+
+  // Copy the run of value bytes up to the closing parenthesis at once. The
+  // scan stops where the checksum has not been calculated yet.
+  void read_value_() {
+    const char *const start = read_pos_;
+    read_pos_ = util::find_first_of<')', '\0'>(start, crc_pos_);
+    if (!skip_object_) {
+      write_(start, read_pos_ - start);
+    }
+  }
+
+  void end_of_data_() {
+    if (status_ == Status::OK) {
+      switch (state_) {
+        case State::START:
+          status_ = Status::START_NOT_FOUND;
+          break;
+        case State::OBIS_CODE:
+          read_obis_code_('\0');
+          if (status_ == Status::OK) {
+            status_ = Status::PARSING_FAILED;
+          }
+          break;
+        case State::IDENTIFICATION:
+        case State::IDENTIFICATION_END:
+        case State::OBJECT:
+        case State::VALUE:
+        case State::OBJECT_END:
+          status_ = Status::PARSING_FAILED;
+          break;
+        case State::LINE_END:
+          end_object_();
+          break;
+        case State::CRC:
+          status_ = Status::INVALID_CRC;
+          break;
+        case State::BODY:
+        case State::DONE:
+          break;
       }
-      next_char_();
     }
-    return obis_code;
+    state_ = State::DONE;
   }
 
-  void read_object_() {
-    auto obis_code = read_obis_code_();
-    if (status_ != Status::OK) {
+  void read_identification_end_(char ch) {
+    if (ch != '\n') {
+      status_ = Status::PARSING_FAILED;
       return;
     }
-    auto *header = write_<Header>(Header{obis_code, 0, 0});
-    while (status_ == Status::OK) {
-      if (eod_) {
-        status_ = Status::PARSING_FAILED;
-      } else if (ch_ == '(') {
-        ++(header->num_values);
-        while (next_char_() != ')' && !eod_) {
-          write_(ch_);
-        }
-        write_('\0');
-      } else if (ch_ == '\r') {
-        ptrdiff_t object_size = write_pos_ - reinterpret_cast<char *>(header);
-        if (next_char_() != '\n') {
-          status_ = Status::PARSING_FAILED;
-        } else if (object_size % 2 != 0) {
-          write_('\0');
-          ++object_size;
+    if (encoding_ == Encoding::COMPACT) {
+      // The same limit as for the NUL-terminated identification
+      if (write_pos_ - value_ > MAX_HEADER_SIZE) {
+        status_ = Status::HEADER_TOO_LONG;
+        return;
+      }
+      end_compact_value_();
+    } else {
+      write_('\0');
+      if (write_pos_ - buffer_ > MAX_HEADER_SIZE) {
+        status_ = Status::HEADER_TOO_LONG;
+        return;
+      }
+    }
+    identification_read_ = true;
+    num_objects_ = write_<uint8_t>(0);
+    if (encoding_ == Encoding::PADDED && (write_pos_ - buffer_) % 2 != 0) {
+      // Add padding to align header to 2 bytes
+      write_('\0');
+    }
+    state_ = State::BODY;
+  }
+
+  void read_body_(char ch) {
+    if (util::is_space(ch)) {
+      return;
+    } else if (ch == '!') {
+      // CRC-16 checksum marker, the checksum covers everything up to and including the marker
+      expected_crc_ = crc_calculator_.crc();
+      crc_ = 0;
+      crc_digits_ = 0;
+      state_ = State::CRC;
+    } else if (util::is_digit(ch)) {
+      // OBIS code
+      obis_key_ = 0;
+      obis_part_ = 0;
+      obis_value_ = 0;
+      state_ = State::OBIS_CODE;
+      read_obis_code_(ch);
+    } else {
+      status_ = Status::PARSING_FAILED;
+    }
+  }
+
+  void read_obis_code_(char ch) {
+    if (util::is_digit(ch)) {
+      const uint8_t val = ch - '0';
+      if (obis_value_ > 25 || (obis_value_ == 25 && val > 5)) {
+        status_ = Status::INVALID_OBIS_CODE;
+        return;
+      }
+      obis_value_ = obis_value_ * 10 + val;
+    } else if ((ch == '-' || ch == ':' || ch == '.' || ch == '*') && obis_part_ <= 4) {
+      obis_key_ = obis_key_ << 8 | obis_value_;
+      obis_value_ = 0;
+      ++obis_part_;
+    } else {
+      // The final part of the obis code is usually omitted
+      if (obis_part_ == 4) {
+        obis_key_ = obis_key_ << 8 | obis_value_;
+      } else if (obis_part_ != 5 || obis_value_ != 255) {
+        // Reading 6-part obis codes is supported but the 6th part must be 255
+        // since only 5 parts are stored.
+        status_ = Status::INVALID_OBIS_CODE;
+        return;
+      }
+      const auto obis_code = ObisCode::from_key(obis_key_);
+      skip_object_ = filter_ != nullptr && !std::binary_search(filter_, filter_end_, obis_code);
+      if (!skip_object_) {
+        if (*num_objects_ == MAX_NUM_OBJECTS) {
+          status_ = Status::TOO_MANY_OBJECTS;
+          return;
         }
-        if (object_size > MAX_OBJECT_SIZE) {
-          status_ = Status::OBJECT_TOO_LONG;
+        if (encoding_ == Encoding::COMPACT) {
+          write_compact_header_(obis_code);
+          if (status_ != Status::OK) {
+            return;
+          }
         } else {
-          header->object_size = static_cast<uint16_t>(object_size);
+          Header header{{}, 0, 0};
+          obis_code.to_bytes(header.obis_code);
+          auto *const written = write_<Header>(header);
+          if (written == nullptr) {
+            return;
+          }
+          object_ = reinterpret_cast<char *>(written);
+          num_values_ = &written->num_values;
         }
+      }
+      state_ = State::OBJECT;
+      read_object_(ch);
+    }
+  }
+
+  void read_object_(char ch) {
+    if (ch == '(') {
+      start_value_();
+    } else if (ch == '\r') {
+      state_ = State::OBJECT_END;
+    }
+  }
+
+  void read_line_end_(char ch) {
+    if (ch == '(') {
+      // Some v2.2 or v3 meters send a new value which starts with '(' on a new
+      // line, while the value belongs to the previous object.
+      start_value_();
+    } else if (!util::is_space(ch)) {
+      end_object_();
+      if (status_ == Status::OK) {
+        state_ = State::BODY;
+        read_body_(ch);
+      }
+    }
+  }
+
+  void start_value_() {
+    if (!skip_object_) {
+      if (*num_values_ == MAX_NUM_VALUES) {
+        status_ = Status::TOO_MANY_VALUES;
         return;
       }
-      next_char_();
-    };
-  }
-
-  uint16_t read_crc_() {
-    uint16_t checksum = 0;
-    for (uint32_t i = 0; i < 4; ++i) {
-      next_char_(false);
-      uint16_t value;
-      if ('0' <= ch_ && ch_ <= '9') {
-        value = ch_ - '0';
-      } else if ('A' <= ch_ && ch_ <= 'F') {
-        value = ch_ - 'A' + 10;
-      } else if ('a' <= ch_ && ch_ <= 'f') {
-        value = ch_ - 'a' + 10;
-      } else {
-        status_ = Status::INVALID_CRC;
-        return 0;
+      ++(*num_values_);
+      if (encoding_ == Encoding::COMPACT) {
+        start_compact_value_();
       }
-      checksum = (checksum << 4) + value;
     }
-    return checksum;
+    state_ = State::VALUE;
+  }
+
+  void end_object_() {
+    if (skip_object_) {
+      return;
+    }
+    ptrdiff_t object_size = write_pos_ - object_;
+    if (encoding_ == Encoding::PADDED && object_size % 2 != 0) {
+      write_('\0');
+      ++object_size;
+    }
+    if (object_size > MAX_OBJECT_SIZE) {
+      status_ = Status::OBJECT_TOO_LONG;
+    } else if (encoding_ == Encoding::PADDED) {
+      reinterpret_cast<Header *>(object_)->object_size = static_cast<uint16_t>(object_size);
+    }
+    ++(*num_objects_);
+  }
+
+  // Write the flags, the OBIS code without its A and B groups if they are shared with the previous object, and the
+  // number of values.
+  void write_compact_header_(const ObisCode &obis_code) {
+    uint8_t obis_bytes[5];
+    obis_code.to_bytes(obis_bytes);
+    const bool shared_prefix = has_prefix_ && obis_bytes[0] == prefix_[0] && obis_bytes[1] == prefix_[1];
+    char header[7];
+    size_t header_size = 0;
+    header[header_size++] = static_cast<char>(shared_prefix ? COMPACT_SHARED_PREFIX : 0);
+    for (size_t i = shared_prefix ? 2 : 0; i < sizeof(obis_bytes); ++i) {
+      header[header_size++] = static_cast<char>(obis_bytes[i]);
+    }
+    header[header_size++] = 0;
+    object_ = write_pos_;
+    write_(header, header_size);
+    if (status_ != Status::OK) {
+      return;
+    }
+    num_values_ = reinterpret_cast<uint8_t *>(write_pos_ - 1);
+    prefix_[0] = obis_bytes[0];
+    prefix_[1] = obis_bytes[1];
+    has_prefix_ = true;
+  }
+
+  // Reserve a byte for the length prefix of the value that follows.
+  void start_compact_value_() {
+    value_ = write_pos_;
+    write_('\0');
+  }
+
+  // Write the length prefix of the value, the value is moved up by a byte if its length needs two.
+  void end_compact_value_() {
+    const size_t value_size = write_pos_ - value_ - 1;
+    if (value_size < 0x80) {
+      *value_ = static_cast<char>(value_size);
+      return;
+    }
+    if (value_size > MAX_VARINT_VALUE) {
+      status_ = Status::OBJECT_TOO_LONG;
+      return;
+    }
+    write_('\0');
+    if (status_ != Status::OK) {
+      return;
+    }
+    std::memmove(&value_[2], &value_[1], value_size);
+    value_[0] = static_cast<char>(0x80 | (value_size & 0x7F));
+    value_[1] = static_cast<char>(value_size >> 7);
+  }
+
+  // Write a sorted index after the objects.
+  const IndexEntry *write_index_() {
+    const char *const write_end = in_place_ ? read_pos_ : buffer_end_;
+    const size_t num_objects = *num_objects_;
+    if (static_cast<size_t>(write_end - write_pos_) < num_objects * INDEX_ENTRY_SIZE ||
+        static_cast<size_t>(write_pos_ - buffer_) / 2 > UINT16_MAX) {
+      return nullptr;
+    }
+    auto *const index = reinterpret_cast<IndexEntry *>(write_pos_);
+    const char *objects = reinterpret_cast<const char *>(num_objects_) + 1;
+    if ((objects - buffer_) % 2 != 0) {
+      ++objects;
+    }
+    util::write_index(buffer_, objects, num_objects, index);
+    write_pos_ += num_objects * INDEX_ENTRY_SIZE;
+    return index;
+  }
+
+  void read_crc_(char ch) {
+    uint16_t value;
+    if ('0' <= ch && ch <= '9') {
+      value = ch - '0';
+    } else if ('A' <= ch && ch <= 'F') {
+      value = ch - 'A' + 10;
+    } else if ('a' <= ch && ch <= 'f') {
+      value = ch - 'a' + 10;
+    } else {
+      status_ = Status::INVALID_CRC;
+      return;
+    }
+    crc_ = (crc_ << 4) + value;
+    if (++crc_digits_ == 4) {
+      if (crc_ != expected_crc_) {
+        status_ = Status::CRC_CHECK_FAILED;
+      }
+      crc_pos_ = read_pos_;
+      state_ = State::BODY;
+    }
   }
 
   CrcCalculator crc_calculator_{};
 
  private:
+  char *buffer_ = nullptr;
+  const char *buffer_end_ = nullptr;
   const char *read_pos_ = nullptr;
+  const char *crc_pos_ = nullptr;
   char *write_pos_ = nullptr;
-  char ch_ = '\0';
-  bool eod_ = false;
-  const char *buffer_end_ = nullptr;
+  bool in_place_ = false;
+  bool index_enabled_ = false;
+  Encoding encoding_ = Encoding::PADDED;
+  State state_ = State::START;
   Status status_ = Status::OK;
+  bool identification_read_ = false;
+  uint8_t *num_objects_ = nullptr;
+  char *object_ = nullptr;
+  uint8_t *num_values_ = nullptr;
+  // The length prefix of the compact value being written
+  char *value_ = nullptr;
+  // The A and B groups of the previous compact object
+  uint8_t prefix_[2]{};
+  bool has_prefix_ = false;
+  bool skip_object_ = false;
+  const ObisCode *filter_ = nullptr;
+  const ObisCode *filter_end_ = nullptr;
+  uint64_t obis_key_ = 0;
+  uint8_t obis_part_ = 0;
+  uint8_t obis_value_ = 0;
+  uint16_t crc_ = 0;
+  uint16_t expected_crc_ = 0;
+  uint8_t crc_digits_ = 0;
 };
 
 using Parser = BaseParser<Crc16Calculator>;
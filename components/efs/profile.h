@@ -0,0 +1,249 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <tuple>
+
+#include "numeric_value.h"
+#include "obis_code.h"
+#include "object.h"
+#include "scan.h"
+#include "timestamp.h"
+#include "value_iterator.h"
+
+namespace esphome {
+namespace efs {
+
+namespace util {
+/// Parse a count of at most 5 digits, e.g. the number of records of a profile.
+inline bool parse_count(std::string_view value, uint32_t &count) {
+  if (value.empty() || value.size() > 5) {
+    return false;
+  }
+  count = 0;
+  for (const char ch : value) {
+    if (!is_digit(ch)) {
+      return false;
+    }
+    count = count * 10 + (ch - '0');
+  }
+  return true;
+}
+
+/// Parse the column OBIS code of a profile, on the format A-B:C.D.E or B:C.D.E, e.g. "0-0:96.7.19".
+///
+/// A is taken to be 0 when it is left out, as in the event log example of the DSMR specification.
+inline bool parse_column_obis_code(std::string_view value, ObisCode &obis_code) {
+  uint8_t parts[5] = {0, 0, 0, 0, 0};
+  const bool has_a = value.find('-') != std::string_view::npos;
+  constexpr char SEPARATORS[] = {'-', ':', '.', '.', '\0'};
+  size_t pos = 0;
+  for (size_t part = has_a ? 0 : 1; part < 5; ++part) {
+    uint16_t part_value = 0;
+    size_t num_digits = 0;
+    for (; pos < value.size() && is_digit(value[pos]); ++pos, ++num_digits) {
+      part_value = part_value * 10 + (value[pos] - '0');
+    }
+    const char separator = pos < value.size() ? value[pos] : '\0';
+    if (num_digits == 0 || num_digits > 3 || part_value > 255 || separator != SEPARATORS[part]) {
+      return false;
+    }
+    parts[part] = static_cast<uint8_t>(part_value);
+    ++pos;
+  }
+  obis_code = ObisCode::from_bytes(parts);
+  return true;
+}
+}  // namespace util
+
+/// How the records of a profile are laid out in the values of the object.
+enum class ProfileLayout : uint8_t {
+  /// (count)(column)(timestamp)(value)..., e.g. the power failure event log 1-0:99.97.0.
+  EVENT_LOG,
+  /// (start)(status)(period)(count)(column)(unit)(value)..., e.g. the hourly gas readings 0-1:24.3.0 of DSMR 2.2 and
+  /// 3.0 meters. The records are period minutes apart.
+  INTERVAL,
+};
+
+/// A record of a ProfileView, its timestamp and value are decoded on demand.
+class Record {
+ public:
+  Record() = default;
+  Record(std::string_view timestamp, int64_t offset, std::string_view value, Unit unit)
+      : timestamp_{timestamp}, offset_{offset}, value_{value}, unit_{unit} {}
+
+  /// Decode the timestamp, std::nullopt if it is not a valid timestamp.
+  std::optional<Timestamp> timestamp() const {
+    Timestamp timestamp;
+    if (!parse_timestamp(timestamp_.data(), timestamp_.size(), timestamp)) {
+      return std::nullopt;
+    }
+    timestamp.local_time += offset_;
+    return timestamp;
+  }
+
+  /// Decode the value, std::nullopt if it is not numeric. A value without a unit has the unit of the profile.
+  std::optional<NumericValue> value() const {
+    NumericValue value;
+    if (!parse_numeric(value_.data(), value_.size(), value)) {
+      return std::nullopt;
+    }
+    if (value.unit == Unit::NONE) {
+      value.unit = unit_;
+    }
+    return value;
+  }
+
+  /// The value as sent by the meter.
+  const std::string_view &raw_value() const { return value_; }
+
+ private:
+  // The timestamp of the record, or of the first record of an interval profile together with the offset in seconds
+  std::string_view timestamp_;
+  int64_t offset_{0};
+  std::string_view value_;
+  Unit unit_{Unit::NONE};
+};
+
+/// Iterates over the records of a ProfileView, decoding the values of the object one record at a time.
+class RecordIterator {
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = const Record;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Record *;
+  using reference = const Record &;
+
+  RecordIterator() = default;
+  /// Iterate over num_records records starting at values. Interval records are interval seconds apart, starting at
+  /// start.
+  RecordIterator(ProfileLayout layout, ValueIterator values, uint32_t num_records, std::string_view start,
+                 uint32_t interval, Unit unit)
+      : layout_{layout},
+        values_{values},
+        remaining_records_{num_records},
+        start_{start},
+        interval_{interval},
+        unit_{unit} {
+    next_();
+  }
+
+  reference operator*() const { return current_; }
+  pointer operator->() const { return &current_; }
+
+  RecordIterator &operator++() {
+    ++index_;
+    next_();
+    return *this;
+  }
+
+  bool operator==(const RecordIterator &other) const { return position_ == other.position_; }
+  bool operator!=(const RecordIterator &other) const { return !(*this == other); }
+
+ private:
+  // Decode the next record, or end the iteration if the object has fewer values than records
+  void next_() {
+    position_ = nullptr;
+    if (remaining_records_ == 0) {
+      return;
+    }
+    --remaining_records_;
+    std::string_view timestamp = start_;
+    if (layout_ == ProfileLayout::EVENT_LOG) {
+      if (values_ == ValueIterator()) {
+        return;
+      }
+      timestamp = std::string_view(std::get<0>(*values_), std::get<1>(*values_));
+      ++values_;
+    }
+    if (values_ == ValueIterator()) {
+      return;
+    }
+    const std::string_view value(std::get<0>(*values_), std::get<1>(*values_));
+    ++values_;
+    current_ = Record(timestamp, static_cast<int64_t>(index_) * interval_, value, unit_);
+    position_ = value.data();
+  }
+
+  ProfileLayout layout_{ProfileLayout::EVENT_LOG};
+  ValueIterator values_{};
+  // The value of the current record, nullptr at the end
+  const char *position_{nullptr};
+  uint32_t remaining_records_{0};
+  uint32_t index_{0};
+  std::string_view start_;
+  uint32_t interval_{0};
+  Unit unit_{Unit::NONE};
+  Record current_{};
+};
+
+/// Lazy view of the records of a profile generic object, e.g. the power failure event log
+/// 1-0:99.97.0(2)(0-0:96.7.19)(101208152415W)(0000000240*s)(101208151004W)(0000000301*s).
+///
+/// Only the leading values with the number of records and the column are
+/// decoded when the view is created. The records refer to the values in the
+/// parsed output and are decoded one at a time while iterating, so the view
+/// must not outlive the output.
+class ProfileView {
+ public:
+  using value_type = Record;
+  using const_iterator = RecordIterator;
+
+  /// Create a view of object, std::nullopt if its values are not laid out as a profile, see ProfileLayout.
+  static std::optional<ProfileView> from_object(const Object &object) {
+    // The leading values of the longest layout
+    std::string_view header[6];
+    auto it = object.begin();
+    size_t num_header_values = 0;
+    for (; it != object.end() && num_header_values < 6; ++it) {
+      header[num_header_values++] = std::string_view(std::get<0>(*it), std::get<1>(*it));
+    }
+    ProfileView view;
+    if (num_header_values >= 2 && util::parse_count(header[0], view.size_) &&
+        util::parse_column_obis_code(header[1], view.column_)) {
+      // The records start after the count and column
+      view.records_ = object.value_at(2);
+      return view;
+    }
+    Timestamp start;
+    uint32_t period;
+    if (num_header_values == 6 && parse_timestamp(header[0].data(), header[0].size(), start) &&
+        util::parse_count(header[2], period) && util::parse_count(header[3], view.size_) &&
+        util::parse_column_obis_code(header[4], view.column_)) {
+      view.layout_ = ProfileLayout::INTERVAL;
+      view.start_ = header[0];
+      view.interval_ = period * 60;
+      view.unit_ = util::parse_unit(header[5].data(), header[5].size());
+      view.records_ = it;
+      return view;
+    }
+    return std::nullopt;
+  }
+
+  ProfileLayout layout() const { return layout_; }
+  /// Number of records according to the meter, the object may hold fewer.
+  uint32_t size() const { return size_; }
+  /// OBIS code of the recorded values, e.g. 0-0:96.7.19 for the duration of power failures.
+  const ObisCode &column() const { return column_; }
+  /// Unit of values without a unit of their own, from the header of an interval profile.
+  Unit unit() const { return unit_; }
+
+  const_iterator begin() const { return const_iterator(layout_, records_, size_, start_, interval_, unit_); }
+  const_iterator end() const { return const_iterator(); }
+
+ private:
+  ProfileView() : column_{0, 0, 0, 0, 0} {}
+
+  ProfileLayout layout_{ProfileLayout::EVENT_LOG};
+  uint32_t size_{0};
+  ObisCode column_;
+  std::string_view start_;
+  uint32_t interval_{0};
+  Unit unit_{Unit::NONE};
+  ValueIterator records_{};
+};
+
+}  // namespace efs
+}  // namespace esphome
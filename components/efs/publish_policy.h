@@ -0,0 +1,62 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace efs {
+
+/// When to publish a new sensor state, the default is to publish every state.
+struct PublishPolicy {
+  /// Only publish when the state differs from the last published state.
+  bool on_change;
+  /// Only publish when the state differs by at least this much from the last published state.
+  float delta;
+  /// Only publish when the state differs by at least this fraction of the last published state.
+  float relative_delta;
+  /// Publish at least this often in milliseconds, regardless of the other settings. 0 disables it.
+  uint32_t heartbeat;
+};
+
+/// Applies a PublishPolicy, remembering the last published state.
+class PublishFilter {
+ public:
+  PublishFilter() = default;
+  explicit PublishFilter(const PublishPolicy &policy) : policy_{policy} {}
+
+  /// Check whether state should be published at time now in milliseconds, and if so record it as published.
+  bool should_publish(float state, uint32_t now) {
+    if (!this->is_due_(state, now)) {
+      return false;
+    }
+    this->last_state_ = state;
+    this->last_time_ = now;
+    this->published_ = true;
+    return true;
+  }
+
+ protected:
+  bool is_due_(float state, uint32_t now) const {
+    if (!this->published_ || std::isnan(state) || std::isnan(this->last_state_)) {
+      return true;
+    }
+    if (this->policy_.heartbeat != 0 && now - this->last_time_ >= this->policy_.heartbeat) {
+      return true;
+    }
+    const float change = std::fabs(state - this->last_state_);
+    if (this->policy_.on_change && change == 0.0f) {
+      return false;
+    }
+    if (change < this->policy_.delta) {
+      return false;
+    }
+    return change >= this->policy_.relative_delta * std::fabs(this->last_state_);
+  }
+
+  PublishPolicy policy_{false, 0.0f, 0.0f, 0};
+  float last_state_{NAN};
+  uint32_t last_time_{0};
+  bool published_{false};
+};
+
+}  // namespace efs
+}  // namespace esphome
@@ -1,7 +1,12 @@
 #pragma once
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <string_view>
 
+#include "header.h"
+#include "obis_code.h"
 #include "object.h"
 #include "object_iterator.h"
 #include "status.h"
@@ -14,18 +19,61 @@ class Result {
   using value_type = Object;
   using const_iterator = ObjectIterator;
 
-  Result(Status status, const char *buffer, size_t buffer_size)
-      : status(status), buffer_(buffer), buffer_size_(buffer_size) {}
+  Result(Status status, const char *buffer, size_t buffer_size, Encoding encoding = Encoding::PADDED)
+      : status(status), buffer_(buffer), buffer_size_(buffer_size), encoding_(encoding) {}
+  Result(Status status, const char *buffer, size_t buffer_size, const IndexEntry *index, size_t index_size)
+      : status(status), buffer_(buffer), buffer_size_(buffer_size), index_(index), index_size_(index_size) {}
 
-  const_iterator begin() const { return const_iterator(buffer_, buffer_size_); }
+  const_iterator begin() const { return const_iterator(buffer_, buffer_size_, encoding_); }
 
   const_iterator end() const { return const_iterator(); }
 
+  /// Find the first object with obis_code.
+  ///
+  /// Uses a binary search when the parser has written an index, otherwise
+  /// the objects are searched in order.
+  std::optional<Object> find(const ObisCode &obis_code) const {
+    if (index_ == nullptr) {
+      auto it = begin();
+      if (it == end()) {
+        return std::nullopt;
+      }
+      // Skip the identification
+      for (++it; it != end(); ++it) {
+        if (it->obis_code() == obis_code) {
+          return Object{it->obis_code(), it->num_values(), it->data(), it->encoding()};
+        }
+      }
+      return std::nullopt;
+    }
+    const IndexEntry *const index_end = &index_[index_size_];
+    const IndexEntry *entry =
+        std::lower_bound(index_, index_end, obis_code, [](const IndexEntry &lhs, const ObisCode &rhs) {
+          return ObisCode::from_bytes(lhs.obis_code) < rhs;
+        });
+    if (entry == index_end || ObisCode::from_bytes(entry->obis_code) != obis_code) {
+      return std::nullopt;
+    }
+    const size_t offset = static_cast<size_t>(entry->offset) * 2;
+    if (offset + HEADER_SIZE > buffer_size_) {
+      return std::nullopt;
+    }
+    const auto *header = reinterpret_cast<const Header *>(&buffer_[offset]);
+    if (header->object_size < HEADER_SIZE || offset + header->object_size > buffer_size_) {
+      return std::nullopt;
+    }
+    return Object{obis_code, header->num_values,
+                  std::string_view(&buffer_[offset + HEADER_SIZE], header->object_size - HEADER_SIZE)};
+  }
+
   const Status status;
 
  private:
   const char *const buffer_;
   const size_t buffer_size_;
+  const Encoding encoding_ = Encoding::PADDED;
+  const IndexEntry *const index_ = nullptr;
+  const size_t index_size_ = 0;
 };
 
 }  // namespace efs
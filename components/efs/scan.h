@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace esphome {
+namespace efs {
+namespace util {
+enum CharClass : uint8_t {
+  CHAR_CLASS_SPACE = 1 << 0,
+  CHAR_CLASS_DIGIT = 1 << 1,
+  CHAR_CLASS_HEX_DIGIT = 1 << 2,
+};
+
+constexpr std::array<uint8_t, 256> init_char_classes() {
+  std::array<uint8_t, 256> table = {0};
+  for (const char ch : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+    table[static_cast<uint8_t>(ch)] |= CHAR_CLASS_SPACE;
+  }
+  for (uint8_t ch = '0'; ch <= '9'; ++ch) {
+    table[ch] |= CHAR_CLASS_DIGIT | CHAR_CLASS_HEX_DIGIT;
+  }
+  for (uint8_t ch = 'A'; ch <= 'F'; ++ch) {
+    table[ch] |= CHAR_CLASS_HEX_DIGIT;
+    table[ch + 'a' - 'A'] |= CHAR_CLASS_HEX_DIGIT;
+  }
+  return table;
+}
+
+constexpr std::array<uint8_t, 256> CHAR_CLASSES = init_char_classes();
+
+// Locale independent replacements for <cctype>
+constexpr bool is_space(char ch) { return (CHAR_CLASSES[static_cast<uint8_t>(ch)] & CHAR_CLASS_SPACE) != 0; }
+constexpr bool is_digit(char ch) { return (CHAR_CLASSES[static_cast<uint8_t>(ch)] & CHAR_CLASS_DIGIT) != 0; }
+constexpr bool is_hex_digit(char ch) { return (CHAR_CLASSES[static_cast<uint8_t>(ch)] & CHAR_CLASS_HEX_DIGIT) != 0; }
+
+template<char... Delimiters> constexpr bool is_any_of(char ch) { return ((ch == Delimiters) || ...); }
+
+/// Find the first occurrence of any of the delimiters in [begin, end).
+///
+/// Several bytes are compared at a time, using SSE2 or NEON when available
+/// and otherwise SWAR on native machine words. Returns end if none of the
+/// delimiters are found.
+template<char... Delimiters> const char *find_first_of(const char *begin, const char *end) {
+  static_assert(sizeof...(Delimiters) > 0, "At least one delimiter is required.");
+  const char *pos = begin;
+#if defined(__SSE2__)
+  for (; end - pos >= 16; pos += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    __m128i matches = _mm_setzero_si128();
+    ((matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(Delimiters)))), ...);
+    const int mask = _mm_movemask_epi8(matches);
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; end - pos >= 16; pos += 16) {
+    const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t *>(pos));
+    uint8x16_t matches = vdupq_n_u8(0);
+    ((matches = vorrq_u8(matches, vceqq_u8(block, vdupq_n_u8(static_cast<uint8_t>(Delimiters))))), ...);
+    if (vmaxvq_u8(matches) != 0) {
+      break;
+    }
+  }
+#else
+  using Word = uintptr_t;
+  constexpr Word ONES = ~Word{0} / 0xFF;
+  constexpr Word HIGH_BITS = ONES * 0x80;
+  // Align the reads to whole words
+  for (; pos != end && reinterpret_cast<uintptr_t>(pos) % sizeof(Word) != 0; ++pos) {
+    if (is_any_of<Delimiters...>(*pos)) {
+      return pos;
+    }
+  }
+  for (; end - pos >= static_cast<ptrdiff_t>(sizeof(Word)); pos += sizeof(Word)) {
+    Word word;
+    std::memcpy(&word, __builtin_assume_aligned(pos, sizeof(Word)), sizeof(Word));
+    // A byte equal to the delimiter becomes zero after the xor, which is detected by the borrow of the subtraction
+    Word matches = 0;
+    ((matches |= ((word ^ (ONES * static_cast<uint8_t>(Delimiters))) - ONES) &
+                 ~(word ^ (ONES * static_cast<uint8_t>(Delimiters))) & HIGH_BITS),
+     ...);
+    if (matches != 0) {
+      break;
+    }
+  }
+#endif
+  for (; pos != end; ++pos) {
+    if (is_any_of<Delimiters...>(*pos)) {
+      return pos;
+    }
+  }
+  return end;
+}
+
+}  // namespace util
+}  // namespace efs
+}  // namespace esphome
@@ -4,24 +4,35 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import sensor
 from esphome.const import (
+    CONF_ACCURACY_DECIMALS,
     CONF_ID,
     DEVICE_CLASS_CURRENT,
     DEVICE_CLASS_ENERGY,
+    DEVICE_CLASS_GAS,
     DEVICE_CLASS_POWER,
     DEVICE_CLASS_VOLTAGE,
     STATE_CLASS_MEASUREMENT,
     STATE_CLASS_TOTAL_INCREASING,
     UNIT_AMPERE,
+    UNIT_CUBIC_METER,
     UNIT_KILOWATT,
     UNIT_KILOWATT_HOURS,
     UNIT_KILOVOLT_AMPS_REACTIVE_HOURS,
     UNIT_KILOVOLT_AMPS_REACTIVE,
     UNIT_VOLT,
 )
-from . import Efs, CONF_EFS_ID
+from . import Efs, CONF_EFS_ID, efs_ns
 
 AUTO_LOAD = ["efs"]
 
+CONF_DELTA = "delta"
+CONF_HEARTBEAT = "heartbeat"
+CONF_ON_CHANGE = "on_change"
+CONF_PUBLISH = "publish"
+CONF_RELATIVE_DELTA = "relative_delta"
+
+PublishPolicy = efs_ns.struct("PublishPolicy")
+
 
 def validate_obis_code(value):
     match = re.match(
@@ -39,6 +50,18 @@ def validate_obis_code(value):
     return match.group(1, 2, 3, 4, 5)
 
 
+PUBLISH_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_ON_CHANGE, default=False): cv.boolean,
+        cv.Optional(CONF_DELTA, default=0.0): cv.positive_float,
+        cv.Optional(CONF_RELATIVE_DELTA, default="0%"): cv.percentage,
+        cv.Optional(
+            CONF_HEARTBEAT, default="0ms"
+        ): cv.positive_time_period_milliseconds,
+    }
+)
+
+
 def obis_code_sensor_schema(*, obis_code=None, **kwargs):
     obis_code_field = (
         cv.Required("obis_code")
@@ -46,7 +69,12 @@ def obis_code_sensor_schema(*, obis_code=None, **kwargs):
         else cv.Optional("obis_code", default=obis_code)
     )
     return sensor.sensor_schema(**kwargs).extend(
-        cv.Schema({obis_code_field: validate_obis_code})
+        cv.Schema(
+            {
+                obis_code_field: validate_obis_code,
+                cv.Optional(CONF_PUBLISH): PUBLISH_SCHEMA,
+            }
+        )
     )
 
 
@@ -254,6 +282,13 @@ CONFIG_SCHEMA = cv.Schema(
             device_class=DEVICE_CLASS_CURRENT,
             state_class=STATE_CLASS_MEASUREMENT,
         ),
+        cv.Optional("gas_consumed"): obis_code_sensor_schema(
+            obis_code="0-1:24.2.1",
+            unit_of_measurement=UNIT_CUBIC_METER,
+            accuracy_decimals=3,
+            device_class=DEVICE_CLASS_GAS,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+        ),
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
@@ -269,8 +304,27 @@ async def to_code(config):
         if id and id.type == sensor.Sensor:
             obis_code = conf.pop("obis_code")
             sens = await sensor.new_sensor(conf)
-            cg.add(getattr(hub, "add_sensor")(obis_code_expr(obis_code), sens))
-            sensors.append(f"F({key})")
+            args = [obis_code_expr(obis_code), sens]
+            # Values are rounded to the accuracy decimals, when they are set
+            if CONF_ACCURACY_DECIMALS in conf or CONF_PUBLISH in conf:
+                args.append(conf.get(CONF_ACCURACY_DECIMALS, efs_ns.NO_ROUNDING))
+            if CONF_PUBLISH in conf:
+                publish = conf[CONF_PUBLISH]
+                args.append(
+                    cg.StructInitializer(
+                        PublishPolicy,
+                        ("on_change", publish[CONF_ON_CHANGE]),
+                        ("delta", publish[CONF_DELTA]),
+                        ("relative_delta", publish[CONF_RELATIVE_DELTA]),
+                        ("heartbeat", publish[CONF_HEARTBEAT].total_milliseconds),
+                    )
+                )
+            sensors.append((tuple(int(part) for part in obis_code), args))
+
+    # Adding the sensors sorted by OBIS code fills the dispatch table without reordering it
+    cg.add(hub.reserve_sensors(len(sensors)))
+    for _, args in sorted(sensors, key=lambda item: item[0]):
+        cg.add(hub.add_sensor(*args))
 
 
 def obis_code_expr(obis_code):
@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "obis_code.h"
+#include "object.h"
+#include "publish_policy.h"
+#include "timestamp.h"
+
+namespace esphome {
+namespace efs {
+
+/// Decimals of a sensor whose values are published without rounding.
+static constexpr int8_t NO_ROUNDING = INT8_MIN;
+
+/// Outcome of SensorTable::publish().
+enum class PublishStatus : uint8_t {
+  /// No sensor is bound to the OBIS code of the object.
+  NO_SENSOR,
+  /// The object has no value.
+  NO_VALUE,
+  /// The value bytes are unchanged since the previous telegram, the previous state was reused.
+  UNCHANGED,
+  /// The value was decoded.
+  DECODED,
+  /// The value could not be parsed as a number.
+  NOT_A_NUMBER,
+  /// The value could not be converted to the state of at least one sensor.
+  VALUE_OVERFLOW,
+};
+
+template<typename Sensor> struct SensorEntry {
+  ObisCode obis_code;
+  Sensor *sensor;
+  int8_t decimals;
+  /// Timestamp of the last published value, for timestamped submeter readings.
+  std::optional<Timestamp> timestamp;
+  PublishFilter publish_filter;
+  /// Fingerprint of the value bytes the state was decoded from.
+  uint32_t fingerprint;
+  /// Last decoded state, reused while the value bytes are unchanged.
+  std::optional<float> state;
+};
+
+/// Flat table mapping OBIS codes to sensors, sorted by OBIS code.
+///
+/// Entries are stored contiguously and looked up by binary search. Several
+/// sensors may be bound to the same OBIS code, they are kept in the order
+/// they were added. Entries is a std::vector, or a StaticVector when the
+/// number of sensors is fixed at compile time.
+template<typename Sensor, typename Entries = std::vector<SensorEntry<Sensor>>> class SensorTable {
+ public:
+  using Entry = SensorEntry<Sensor>;
+  using iterator = typename Entries::iterator;
+  using const_iterator = typename Entries::const_iterator;
+
+  /// Reserve space for num_sensors entries to avoid reallocating while adding them.
+  void reserve(size_t num_sensors) { entries_.reserve(num_sensors); }
+
+  /// Add a sensor for obis_code, returns false if the table is full.
+  bool add(const ObisCode &obis_code, Sensor *sensor, int8_t decimals, const PublishPolicy &policy = {}) {
+    const auto pos = std::upper_bound(entries_.begin(), entries_.end(), obis_code,
+                                      [](const ObisCode &code, const Entry &entry) { return code < entry.obis_code; });
+    const size_t size = entries_.size();
+    entries_.insert(pos, Entry{obis_code, sensor, decimals, std::nullopt, PublishFilter(policy), 0, std::nullopt});
+    return entries_.size() > size;
+  }
+
+  /// Get the entries bound to obis_code.
+  std::pair<iterator, iterator> find(const ObisCode &obis_code) {
+    const auto first =
+        std::lower_bound(entries_.begin(), entries_.end(), obis_code,
+                         [](const Entry &entry, const ObisCode &code) { return entry.obis_code < code; });
+    auto last = first;
+    while (last != entries_.end() && last->obis_code == obis_code) {
+      ++last;
+    }
+    return {first, last};
+  }
+
+  /// Get the distinct OBIS codes in the table, in sorted order.
+  template<typename ObisCodes = std::vector<ObisCode>> ObisCodes obis_codes() const {
+    ObisCodes obis_codes;
+    for (const auto &entry : entries_) {
+      if (obis_codes.empty() || obis_codes.back() != entry.obis_code) {
+        obis_codes.push_back(entry.obis_code);
+      }
+    }
+    return obis_codes;
+  }
+
+  /// Decode the value of object and publish it to the sensors bound to its OBIS code at time now in milliseconds.
+  ///
+  /// Objects whose value bytes are unchanged since the previous telegram
+  /// are not decoded again. For timestamped submeter readings, e.g.
+  /// 0-1:24.2.1(101209110000W)(12785.123*m3), the last value is published
+  /// and only when the timestamp has changed.
+  PublishStatus publish(const Object &object, uint32_t now) {
+    const auto entries = find(object.obis_code());
+    if (entries.first == entries.second) {
+      return PublishStatus::NO_SENSOR;
+    }
+    if (object.num_values() <= 0) {
+      return PublishStatus::NO_VALUE;
+    }
+    const uint32_t fingerprint = object.fingerprint();
+    bool unchanged = true;
+    for (auto entry = entries.first; entry != entries.second && unchanged; ++entry) {
+      unchanged = entry->state.has_value() && entry->fingerprint == fingerprint;
+    }
+    if (unchanged) {
+      for (auto entry = entries.first; entry != entries.second; ++entry) {
+        // Unchanged submeter readings are not published again
+        if (!entry->timestamp.has_value() && entry->publish_filter.should_publish(*entry->state, now)) {
+          entry->sensor->publish_state(*entry->state);
+        }
+      }
+      return PublishStatus::UNCHANGED;
+    }
+    const auto timestamp = object.num_values() > 1 ? object.timestamp() : std::nullopt;
+    const uint8_t index = timestamp.has_value() ? object.num_values() - 1 : 0;
+    // Decode the value exactly and only round it when converting it to the sensor state
+    const auto value = object.numeric(index);
+    if (!value.has_value()) {
+      return PublishStatus::NOT_A_NUMBER;
+    }
+    auto status = PublishStatus::DECODED;
+    for (auto entry = entries.first; entry != entries.second; ++entry) {
+      if (timestamp.has_value()) {
+        if (entry->timestamp == timestamp) {
+          // Remember the value bytes so that the reading is not decoded again in the next telegram
+          entry->fingerprint = fingerprint;
+          continue;
+        }
+        entry->timestamp = timestamp;
+      }
+      const auto state = entry->decimals == NO_ROUNDING ? value->to_float() : value->to_float(entry->decimals);
+      if (!state.has_value()) {
+        status = PublishStatus::VALUE_OVERFLOW;
+        continue;
+      }
+      entry->fingerprint = fingerprint;
+      entry->state = state;
+      if (entry->publish_filter.should_publish(*state, now)) {
+        entry->sensor->publish_state(*state);
+      }
+    }
+    return status;
+  }
+
+  size_t size() const { return entries_.size(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+ protected:
+  Entries entries_;
+};
+
+}  // namespace efs
+}  // namespace esphome
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace esphome {
+namespace efs {
+
+/// Vector with a capacity of N elements stored inline, for builds that do not allocate from the heap after boot.
+///
+/// Provides the subset of the std::vector interface used by the component.
+/// Adding an element to a full vector fails instead of reallocating.
+template<typename T, size_t N> class StaticVector {
+ public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  StaticVector() = default;
+  StaticVector(const StaticVector &other) {
+    for (const auto &value : other) {
+      push_back(value);
+    }
+  }
+  StaticVector &operator=(const StaticVector &other) {
+    if (this != &other) {
+      clear();
+      for (const auto &value : other) {
+        push_back(value);
+      }
+    }
+    return *this;
+  }
+  ~StaticVector() { clear(); }
+
+  /// Append value, returns false if the vector is full.
+  bool push_back(const T &value) {
+    if (size_ == N) {
+      return false;
+    }
+    new (&data()[size_]) T(value);
+    ++size_;
+    return true;
+  }
+
+  /// Insert value before pos, returns end() if the vector is full.
+  iterator insert(const_iterator pos, const T &value) {
+    const size_t index = pos - begin();
+    if (size_ == N) {
+      return end();
+    }
+    if (index == size_) {
+      push_back(value);
+      return &data()[index];
+    }
+    // Move the last element to the free slot and shift the others up by one
+    new (&data()[size_]) T(std::move(data()[size_ - 1]));
+    std::move_backward(&data()[index], &data()[size_ - 1], &data()[size_]);
+    data()[index] = value;
+    ++size_;
+    return &data()[index];
+  }
+
+  void clear() {
+    for (auto &value : *this) {
+      value.~T();
+    }
+    size_ = 0;
+  }
+
+  /// The capacity is fixed, reserving is a no-op.
+  void reserve(size_t /*size*/) {}
+
+  static constexpr size_t capacity() { return N; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  T *data() { return reinterpret_cast<T *>(storage_); }
+  const T *data() const { return reinterpret_cast<const T *>(storage_); }
+  T &operator[](size_t index) { return data()[index]; }
+  const T &operator[](size_t index) const { return data()[index]; }
+  T &back() { return data()[size_ - 1]; }
+  const T &back() const { return data()[size_ - 1]; }
+
+  iterator begin() { return data(); }
+  iterator end() { return &data()[size_]; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return &data()[size_]; }
+
+ protected:
+  alignas(T) unsigned char storage_[N * sizeof(T)];
+  size_t size_{0};
+};
+
+}  // namespace efs
+}  // namespace esphome
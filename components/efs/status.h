@@ -12,6 +12,7 @@ enum class Status {
   HEADER_TOO_LONG,
   OBJECT_TOO_LONG,
   TOO_MANY_OBJECTS,
+  TOO_MANY_VALUES,
   INVALID_CRC,
   CRC_CHECK_FAILED,
 };
@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace efs {
+
+/// Telegram buffers shared by several meters, which borrow a buffer while they receive and parse a telegram.
+///
+/// The buffers are allocated once by allocate(), with the size needed by the
+/// largest client. A client that finds no free buffer at the start of a
+/// telegram is put in a queue. The buffers that become free are then held for
+/// the clients in the queue, in the order they were refused, so that a meter
+/// that sends often can not keep taking the buffers from one that sends
+/// rarely. A client that has not asked again within the reservation timeout
+/// is dropped from the queue.
+class TelegramPool {
+ public:
+  static constexpr size_t MAX_BUFFERS = 8;
+  static constexpr size_t MAX_CLIENTS = 8;
+  static constexpr uint8_t NO_CLIENT = 0xFF;
+
+  TelegramPool() = default;
+  TelegramPool(const TelegramPool &) = delete;
+  TelegramPool &operator=(const TelegramPool &) = delete;
+  ~TelegramPool() { delete[] storage_; }
+
+  /// Register a client which receives telegrams of up to buffer_size bytes, returns its id or NO_CLIENT if there are
+  /// too many clients.
+  uint8_t add_client(size_t buffer_size) {
+    if (num_clients_ == MAX_CLIENTS || storage_ != nullptr) {
+      return NO_CLIENT;
+    }
+    // Rounded up so that every buffer is 4-byte aligned
+    buffer_size_ = std::max(buffer_size_, (buffer_size + 3) & ~static_cast<size_t>(3));
+    return num_clients_++;
+  }
+
+  /// Have at least num_buffers buffers, up to MAX_BUFFERS.
+  void require_buffers(size_t num_buffers) {
+    num_buffers_ = std::min(std::max(num_buffers_, num_buffers), MAX_BUFFERS);
+  }
+
+  /// Set how long, in milliseconds, a free buffer is held for a refused client that does not ask again.
+  void set_reservation_timeout(uint32_t timeout) { reservation_timeout_ = timeout; }
+
+  /// Allocate the buffers, once all clients have been added. Further calls do nothing.
+  void allocate() {
+    if (storage_ == nullptr && num_buffers_ > 0 && buffer_size_ > 0) {
+      storage_ = new char[num_buffers_ * buffer_size_];  // NOLINT
+    }
+  }
+
+  /// Borrow a buffer for client, returns nullptr if there is no buffer free for it.
+  char *acquire(uint8_t client, uint32_t now) {
+    if (storage_ == nullptr || client >= num_clients_) {
+      return nullptr;
+    }
+    expire_waiting_(now);
+    const size_t num_free = num_buffers_ - num_in_use_();
+    const size_t position = waiting_position_(client);
+    // A free buffer goes to the clients that have waited longest, any others are free for all
+    const bool granted = position < num_waiting_ ? position < num_free : num_free > num_waiting_;
+    if (!granted) {
+      wait_(client, position, now);
+      return nullptr;
+    }
+    if (position < num_waiting_) {
+      std::move(&waiting_[position + 1], &waiting_[num_waiting_], &waiting_[position]);
+      --num_waiting_;
+    }
+    for (size_t i = 0; i < num_buffers_; ++i) {
+      if ((in_use_ & (1u << i)) == 0) {
+        in_use_ |= 1u << i;
+        return &storage_[i * buffer_size_];
+      }
+    }
+    return nullptr;
+  }
+
+  /// Return a buffer from acquire() to the pool.
+  void release(const char *buffer) {
+    if (storage_ == nullptr || buffer < storage_) {
+      return;
+    }
+    const size_t index = (buffer - storage_) / buffer_size_;
+    if (index < num_buffers_) {
+      in_use_ &= ~(1u << index);
+    }
+  }
+
+  size_t buffer_size() const { return buffer_size_; }
+  size_t num_buffers() const { return num_buffers_; }
+  size_t num_clients() const { return num_clients_; }
+  /// Number of clients waiting for a buffer.
+  size_t num_waiting() const { return num_waiting_; }
+
+ protected:
+  struct Waiting {
+    uint8_t client;
+    // When the client last asked for a buffer
+    uint32_t since;
+  };
+
+  size_t num_in_use_() const {
+    size_t count = 0;
+    for (uint32_t bits = in_use_; bits != 0; bits &= bits - 1) {
+      ++count;
+    }
+    return count;
+  }
+
+  size_t waiting_position_(uint8_t client) const {
+    size_t position = 0;
+    while (position < num_waiting_ && waiting_[position].client != client) {
+      ++position;
+    }
+    return position;
+  }
+
+  // Queue client, or keep its place in the queue if it is already waiting
+  void wait_(uint8_t client, size_t position, uint32_t now) {
+    if (position == num_waiting_) {
+      waiting_[num_waiting_++] = Waiting{client, now};
+    } else {
+      waiting_[position].since = now;
+    }
+  }
+
+  void expire_waiting_(uint32_t now) {
+    const auto expired = [this, now](const Waiting &waiting) { return now - waiting.since > reservation_timeout_; };
+    const Waiting *const end = std::remove_if(&waiting_[0], &waiting_[num_waiting_], expired);
+    num_waiting_ = end - &waiting_[0];
+  }
+
+  char *storage_{nullptr};
+  size_t buffer_size_{0};
+  size_t num_buffers_{0};
+  uint32_t in_use_{0};
+  uint8_t num_clients_{0};
+  Waiting waiting_[MAX_CLIENTS]{};
+  size_t num_waiting_{0};
+  uint32_t reservation_timeout_{15000};
+};
+
+}  // namespace efs
+}  // namespace esphome
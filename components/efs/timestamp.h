@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "scan.h"
+
+namespace esphome {
+namespace efs {
+
+struct Timestamp {
+  /// Seconds since 1970-01-01 00:00:00 in the meter's local time.
+  int64_t local_time;
+  /// Whether daylight saving time is in effect.
+  bool dst;
+
+  /// Convert to Unix time, given the meter's UTC offset in seconds during standard time, e.g. 3600 for CET.
+  int64_t to_epoch(int32_t utc_offset) const { return local_time - utc_offset - (dst ? 3600 : 0); }
+
+  friend bool operator==(const Timestamp &lhs, const Timestamp &rhs) {
+    return lhs.local_time == rhs.local_time && lhs.dst == rhs.dst;
+  }
+  friend bool operator!=(const Timestamp &lhs, const Timestamp &rhs) { return !(lhs == rhs); }
+};
+
+namespace util {
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar, see
+// http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+constexpr int64_t days_from_civil(int32_t year, uint32_t month, uint32_t day) {
+  year -= month <= 2 ? 1 : 0;
+  const int32_t era = (year >= 0 ? year : year - 399) / 400;
+  const auto year_of_era = static_cast<uint32_t>(year - era * 400);
+  const uint32_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return static_cast<int64_t>(era) * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+constexpr uint8_t days_in_month(uint32_t year, uint8_t month) {
+  if (month == 2) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0 ? 29 : 28;
+  }
+  return month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31;
+}
+}  // namespace util
+
+/// Parse a timestamp on the format YYMMDDhhmmssX, e.g. "101209113020W".
+///
+/// X is S during daylight saving time and W otherwise, it is omitted by
+/// some older meters. Returns false if the value is not a valid timestamp.
+inline bool parse_timestamp(const char *data, size_t size, Timestamp &timestamp) {
+  if (size != 12 && size != 13) {
+    return false;
+  }
+  uint8_t fields[6];
+  for (size_t i = 0; i < 6; ++i) {
+    if (!util::is_digit(data[2 * i]) || !util::is_digit(data[2 * i + 1])) {
+      return false;
+    }
+    fields[i] = (data[2 * i] - '0') * 10 + (data[2 * i + 1] - '0');
+  }
+  const uint32_t year = 2000 + fields[0];
+  const uint8_t month = fields[1];
+  const uint8_t day = fields[2];
+  if (month < 1 || month > 12 || day < 1 || day > util::days_in_month(year, month) || fields[3] > 23 ||
+      fields[4] > 59 || fields[5] > 59) {
+    return false;
+  }
+  bool dst = false;
+  if (size == 13) {
+    if (data[12] == 'S') {
+      dst = true;
+    } else if (data[12] != 'W') {
+      return false;
+    }
+  }
+  const int64_t days = util::days_from_civil(year, month, day);
+  timestamp = Timestamp{days * 86400 + fields[3] * 3600 + fields[4] * 60 + fields[5], dst};
+  return true;
+}
+
+}  // namespace efs
+}  // namespace esphome
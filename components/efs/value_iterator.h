@@ -4,9 +4,12 @@
 #include <iterator>
 #include <tuple>
 
+#include "header.h"
+
 namespace esphome {
 namespace efs {
 
+/// Iterates over the values of an object, which are NUL-terminated or length prefixed depending on the Encoding.
 class ValueIterator {
  public:
   using iterator_category = std::input_iterator_tag;
@@ -15,10 +18,19 @@ class ValueIterator {
   using pointer = value_type *;
   using reference = value_type &;
 
-  ValueIterator() : buffer_(nullptr), buffer_size_(0), remaining_values_(0), current_{nullptr, 0} {};
+  ValueIterator()
+      : buffer_(nullptr),
+        buffer_size_(0),
+        remaining_values_(0),
+        encoding_(Encoding::PADDED),
+        current_{nullptr, 0} {};
 
-  ValueIterator(const char *buffer, size_t buffer_size, uint8_t num_values)
-      : buffer_(buffer), buffer_size_(buffer_size), remaining_values_(num_values), current_() {
+  ValueIterator(const char *buffer, size_t buffer_size, uint8_t num_values, Encoding encoding = Encoding::PADDED)
+      : buffer_(buffer),
+        buffer_size_(buffer_size),
+        remaining_values_(num_values),
+        encoding_(encoding),
+        current_() {
     if (buffer_ == nullptr || buffer_size == 0 || num_values == 0) {
       buffer_ = nullptr;
       return;
@@ -35,8 +47,9 @@ class ValueIterator {
       return *this;
     }
 
-    // Skip past current string and its terminating null
-    size_t value_size = std::get<1>(current_) + 1;
+    // Skip past the current value and its length prefix or terminating null
+    const size_t value_size = (std::get<0>(current_) - buffer_) + std::get<1>(current_) +
+                              (encoding_ == Encoding::PADDED ? 1 : 0);
     if (value_size >= buffer_size_) {
       buffer_ = nullptr;
       return *this;
@@ -59,6 +72,17 @@ class ValueIterator {
 
  private:
   void next_() {
+    if (encoding_ == Encoding::COMPACT) {
+      const char *value = buffer_;
+      const char *const end = &buffer_[buffer_size_];
+      size_t value_size;
+      if (!util::read_varint(value, end, value_size) || value_size > static_cast<size_t>(end - value)) {
+        buffer_ = nullptr;
+        return;
+      }
+      current_ = {value, value_size};
+      return;
+    }
     size_t value_size = strnlen(buffer_, buffer_size_);
     if (value_size == buffer_size_) {
       buffer_ = nullptr;
@@ -70,6 +94,7 @@ class ValueIterator {
   const char *buffer_;
   size_t buffer_size_;
   uint8_t remaining_values_;
+  Encoding encoding_;
   std::tuple<const char *, size_t> current_;
 };
 
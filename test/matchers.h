@@ -1,4 +1,6 @@
 #pragma once
+#include <string_view>
+
 #include <gmock/gmock.h>
 
 #include "components/efs/object.h"
@@ -6,13 +8,13 @@
 namespace esphome::efs::testing {
 
 using ::testing::AllOf;
-using ::testing::FieldsAre;
 using ::testing::Property;
-using ::testing::StrEq;
 
 // Keep custom matcher names consistent with GTest matchers. NOLINTBEGIN(readability-identifier-naming)
+// Compares the value by its size, since compact values are not NUL-terminated
 MATCHER_P(ValueEq, value, "") {
-  return ExplainMatchResult(FieldsAre(StrEq(value), strlen(value)), arg, result_listener);
+  return ExplainMatchResult(std::string_view(value), std::string_view(std::get<0>(arg), std::get<1>(arg)),
+                            result_listener);
 }
 
 MATCHER_P(ValueArray, values, "") {
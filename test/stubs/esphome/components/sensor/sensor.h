@@ -0,0 +1,29 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    ++this->num_published;
+    if (this->callback_) {
+      this->callback_(state);
+    }
+  }
+  void add_on_state_callback(std::function<void(float)> &&callback) { this->callback_ = std::move(callback); }
+
+  float state{NAN};
+  uint32_t num_published{0};
+
+ protected:
+  std::function<void(float)> callback_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor {};
+
+}  // namespace text_sensor
+}  // namespace esphome
@@ -0,0 +1,49 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace esphome {
+namespace uart {
+
+/// A UART whose RX buffer is filled by the tests.
+class UARTComponent {
+ public:
+  /// Append data to the RX buffer. Reserve the space up front to receive without allocating.
+  void receive(const std::string &data) {
+    this->rx_.erase(0, this->rx_pos_);
+    this->rx_pos_ = 0;
+    this->rx_ += data;
+  }
+  void reserve(size_t size) { this->rx_.reserve(size); }
+
+  int available() const { return static_cast<int>(this->rx_.size() - this->rx_pos_); }
+  bool read_array(uint8_t *data, size_t size) {
+    if (size > this->rx_.size() - this->rx_pos_) {
+      return false;
+    }
+    std::memcpy(data, &this->rx_[this->rx_pos_], size);
+    this->rx_pos_ += size;
+    return true;
+  }
+
+ protected:
+  std::string rx_;
+  size_t rx_pos_{0};
+};
+
+class UARTDevice {
+ public:
+  UARTDevice(UARTComponent *parent) : parent_{parent} {}
+
+  int available() { return this->parent_->available(); }
+  bool read_array(uint8_t *data, size_t size) { return this->parent_->read_array(data, size); }
+
+ protected:
+  UARTComponent *parent_;
+};
+
+}  // namespace uart
+}  // namespace esphome
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+
+  void status_clear_warning() {}
+};
+
+class GPIOPin {
+ public:
+  void setup() {}
+  void digital_write(bool value) { this->value_ = value; }
+  bool digital_read() const { return this->value_; }
+
+ protected:
+  bool value_{false};
+};
+
+}  // namespace esphome
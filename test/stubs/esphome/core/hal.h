@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+
+namespace esphome {
+
+namespace testing {
+/// Time in microseconds since boot, set by the tests.
+inline uint32_t now_us = 0;
+}  // namespace testing
+
+inline uint32_t micros() { return testing::now_us; }
+inline uint32_t millis() { return testing::now_us / 1000; }
+inline void delay(uint32_t ms) { testing::now_us += ms * 1000; }
+
+}  // namespace esphome
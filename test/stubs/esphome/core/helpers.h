@@ -0,0 +1,15 @@
+#pragma once
+
+namespace esphome {
+
+class HighFrequencyLoopRequester {
+ public:
+  void start() { this->started_ = true; }
+  void stop() { this->started_ = false; }
+  bool is_started() const { return this->started_; }
+
+ protected:
+  bool started_{false};
+};
+
+}  // namespace esphome
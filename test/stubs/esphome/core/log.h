@@ -0,0 +1,17 @@
+#pragma once
+
+namespace esphome {
+namespace testing {
+// Log messages are dropped, without formatting them
+template<typename... Args> void log(const char * /*tag*/, const char * /*format*/, Args &&.../*args*/) {}
+}  // namespace testing
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::testing::log(tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::testing::log(tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::testing::log(tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::testing::log(tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::testing::log(tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::testing::log(tag, __VA_ARGS__)
+#define LOG_PIN(prefix, pin) ::esphome::testing::log(TAG, prefix, pin)
+#define YESNO(b) ((b) ? "YES" : "NO")
@@ -0,0 +1,24 @@
+#pragma once
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+// Directory of the telegram corpus, set by the build
+#ifndef EFS_TELEGRAM_DIR
+#define EFS_TELEGRAM_DIR "test/telegrams"
+#endif
+
+namespace esphome::efs::testing {
+
+/// Plain text telegrams in test/telegrams, see test/telegrams/README.md.
+const std::array<const char *, 6> TELEGRAM_CORPUS{"dsmr22_iskra.txt", "dsmr4_landis.txt", "dsmr5_kaifa.txt",
+                                                  "be_fluvius.txt",   "se_aidon.txt",     "lu_smarty.txt"};
+
+/// Read a file from the telegram corpus, returns an empty string if it can not be read.
+inline std::string load_telegram(const std::string &name) {
+  std::ifstream file(std::string(EFS_TELEGRAM_DIR) + "/" + name, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}  // namespace esphome::efs::testing
@@ -0,0 +1,72 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "components/efs/crc16.h"
+#include "components/efs/parser.h"
+
+namespace esphome::efs::testing {
+
+/// Shape of a generated telegram.
+struct TelegramShape {
+  size_t num_objects = 10;
+  size_t num_values = 1;
+  /// Number of characters of each value.
+  size_t value_size = 10;
+  /// Number of characters of the identification, excluding the leading '/'.
+  size_t identification_size = 16;
+  /// Use hex strings instead of decimal numbers as values.
+  bool hex_values = false;
+};
+
+/// OBIS code of generated object index, unique and increasing with the index.
+inline std::string generated_obis_code(size_t index) {
+  return "1-" + std::to_string(index / 200) + ":" + std::to_string(index % 200 + 1) + ".8.0";
+}
+
+/// Generate a valid telegram with a correct CRC-16 checksum.
+inline std::string generate_telegram(const TelegramShape &shape) {
+  static const char DIGITS[] = "0123456789ABCDEF";
+  std::string value;
+  for (size_t i = 0; i < shape.value_size; ++i) {
+    value += DIGITS[i % (shape.hex_values ? 16 : 10)];
+  }
+  if (!shape.hex_values && shape.value_size >= 5) {
+    value[shape.value_size - 4] = '.';
+  }
+
+  std::string telegram = "/";
+  for (size_t i = 0; i < shape.identification_size; ++i) {
+    telegram += static_cast<char>('A' + i % 26);
+  }
+  telegram += "\r\n\r\n";
+  for (size_t i = 0; i < shape.num_objects; ++i) {
+    telegram += generated_obis_code(i);
+    for (size_t j = 0; j < shape.num_values; ++j) {
+      telegram += '(' + value + ')';
+    }
+    telegram += "\r\n";
+  }
+  telegram += '!';
+
+  Crc16Calculator crc_calculator;
+  crc_calculator.update(telegram.data(), telegram.size());
+  char crc[5];
+  std::snprintf(crc, sizeof(crc), "%04X", crc_calculator.crc());
+  return telegram + crc + "\r\n";
+}
+
+/// Generate a telegram of approximately size bytes with single value objects.
+inline std::string generate_telegram_of_size(size_t size) {
+  // Lines are about 64 bytes until the maximum number of objects is reached, then they grow
+  constexpr size_t LINE_OVERHEAD = 16;
+  TelegramShape shape;
+  shape.num_objects = std::clamp<size_t>(size / 64, 1, MAX_NUM_OBJECTS);
+  const size_t body_size = size > 32 ? size - 32 : 0;
+  shape.value_size = std::max<size_t>(body_size / shape.num_objects, LINE_OVERHEAD + 1) - LINE_OVERHEAD;
+  return generate_telegram(shape);
+}
+
+}  // namespace esphome::efs::testing
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "components/efs/framer.h"
+#include "components/efs/header.h"
+#include "components/efs/parser.h"
+#include "components/efs/result.h"
+#include "matchers.h"
+#include "telegram_corpus.h"
+
+using ::testing::ElementsAre;
+using esphome::efs::testing::ObjectLike;
+using esphome::efs::testing::ValueEq;
+using std::literals::operator""sv;
+
+namespace esphome::efs {
+namespace {
+
+class StubCrcCalculator {
+ public:
+  void update(const char &) {}
+  void update(const char *, size_t) {}
+  void reset() {}
+  uint16_t crc() { return 0; }
+};
+
+struct ParsedObject {
+  ObisCode obis_code;
+  std::vector<std::string> values;
+
+  bool operator==(const ParsedObject &other) const {
+    return obis_code == other.obis_code && values == other.values;
+  }
+};
+
+std::vector<ParsedObject> objects(const Result &result) {
+  std::vector<ParsedObject> parsed;
+  for (const auto &object : result) {
+    ParsedObject &entry = parsed.emplace_back(ParsedObject{object.obis_code(), {}});
+    for (const auto &[value, size] : object) {
+      entry.values.emplace_back(value, size);
+    }
+  }
+  return parsed;
+}
+
+class CompactEncodingTest : public ::testing::Test {
+ protected:
+  void SetUp() override { parser_.set_encoding(Encoding::COMPACT); }
+
+  Result parse(std::string &telegram) { return parser_.parse_telegram(telegram.data(), telegram.size()); }
+
+  BaseParser<StubCrcCalculator> parser_;
+};
+
+TEST_F(CompactEncodingTest, ParsedDataLayout) {
+  std::string telegram("/XYZ5\r\n\r\n1-0:1.8.1(000123.456*kWh)\r\n1-0:1.8.2(1)(2)\r\n0-0:96.1.1()\r\n!0000");
+  const auto result = parse(telegram);
+  ASSERT_EQ(result.status, Status::OK);
+
+  // Identification, number of objects, then flags, OBIS code, number of values and length prefixed values
+  const auto expected = "\x04XYZ5\x03"
+                        "\x00\x01\x00\x01\x08\x01\x01\x0E"
+                        "000123.456*kWh"
+                        "\x01\x01\x08\x02\x02\x01"
+                        "1\x01"
+                        "2"
+                        "\x00\x00\x00\x60\x01\x01\x01\x00"sv;
+  EXPECT_EQ(std::string_view(telegram.data(), expected.size()), expected);
+
+  EXPECT_THAT(result, ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"XYZ5"}),
+                                  ObjectLike(ObisCode(1, 0, 1, 8, 1), std::vector<const char *>{"000123.456*kWh"}),
+                                  ObjectLike(ObisCode(1, 0, 1, 8, 2), std::vector<const char *>{"1", "2"}),
+                                  ObjectLike(ObisCode(0, 0, 96, 1, 1), std::vector<const char *>{""})));
+}
+
+TEST_F(CompactEncodingTest, LongValuesHaveTwoByteLength) {
+  const std::string value(300, 'x');
+  std::string telegram = "/XYZ5\r\n\r\n0-0:96.13.0(" + value + ")\r\n1-0:1.8.1(1)\r\n!0000";
+  const auto result = parse(telegram);
+  ASSERT_EQ(result.status, Status::OK);
+
+  const std::string_view layout(telegram.data(), 15);
+  EXPECT_EQ(layout, "\x04XYZ5\x02\x00\x00\x00\x60\x0D\x00\x01\xAC\x02"sv);
+  EXPECT_THAT(result, ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"XYZ5"}),
+                                  ObjectLike(ObisCode(0, 0, 96, 13, 0), std::vector<const char *>{value.c_str()}),
+                                  ObjectLike(ObisCode(1, 0, 1, 8, 1), std::vector<const char *>{"1"})));
+}
+
+TEST_F(CompactEncodingTest, BufferNeedsNoAlignment) {
+  const std::string telegram("/XYZ5\r\n\r\n1-0:1.8.1(000123.456*kWh)\r\n!0000");
+  alignas(2) char buffer[64];
+  parser_.begin(&buffer[1], sizeof(buffer) - 1);
+  parser_.feed(telegram.data(), telegram.size());
+  const auto result = parser_.finish();
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"XYZ5"}),
+                                  ObjectLike(ObisCode(1, 0, 1, 8, 1), std::vector<const char *>{"000123.456*kWh"})));
+}
+
+TEST_F(CompactEncodingTest, FindSearchesInOrder) {
+  parser_.set_index(true);
+  std::string telegram("/XYZ5\r\n\r\n1-0:2.8.1(2)\r\n1-0:1.8.1(1)\r\n!0000");
+  const auto result = parse(telegram);
+  ASSERT_EQ(result.status, Status::OK);
+  const auto object = result.find(ObisCode(1, 0, 1, 8, 1));
+  ASSERT_TRUE(object.has_value());
+  EXPECT_THAT(*object, ElementsAre(ValueEq("1")));
+  EXPECT_FALSE(result.find(ObisCode(1, 0, 3, 8, 1)).has_value());
+}
+
+TEST_F(CompactEncodingTest, FilteredObjectsDoNotShareTheirPrefix) {
+  const ObisCode filter[] = {ObisCode(0, 0, 96, 1, 1), ObisCode(1, 0, 1, 8, 2)};
+  parser_.set_filter(filter, 2);
+  std::string telegram("/XYZ5\r\n\r\n1-0:1.8.1(1)\r\n0-0:96.1.1(2)\r\n1-0:1.8.2(3)\r\n!0000");
+  const auto result = parse(telegram);
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_EQ(std::string_view(telegram.data(), 23),
+            "\x04XYZ5\x02\x00\x00\x00\x60\x01\x01\x01\x01"
+            "2"
+            "\x00\x01\x00\x01\x08\x02\x01\x01"sv);
+  EXPECT_THAT(result, ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"XYZ5"}),
+                                  ObjectLike(ObisCode(0, 0, 96, 1, 1), std::vector<const char *>{"2"}),
+                                  ObjectLike(ObisCode(1, 0, 1, 8, 2), std::vector<const char *>{"3"})));
+}
+
+TEST_F(CompactEncodingTest, TruncatedOutputEndsIteration) {
+  const char buffer[] = "\x04XYZ5\x02"
+                        "\x00\x01\x00\x01\x08\x01\x01\x05"
+                        "12";
+  const auto result = Result(Status::OK, buffer, sizeof(buffer) - 1, Encoding::COMPACT);
+  EXPECT_THAT(result, ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"XYZ5"})));
+}
+
+TEST(CompactEncodingStreamTest, TelegramLargerThanBufferFits) {
+  // Framed in chunks from the UART and parsed as it arrives, as the component does, into a buffer which only holds
+  // the objects with a sensor
+  const std::string telegram = testing::load_telegram("dsmr5_kaifa.txt");
+  ASSERT_FALSE(telegram.empty());
+  const ObisCode filter[] = {POWER_IMPORTED, ENERGY_IMPORTED_TARIFF1};
+  Parser parser;
+  parser.set_encoding(Encoding::COMPACT);
+  parser.set_filter(filter, 2);
+  std::vector<char> buffer(telegram.size() / 4);
+  TelegramFramer framer;
+  std::vector<Result> results;
+  for (size_t offset = 0; offset < telegram.size(); offset += 64) {
+    const char *chunk = &telegram[offset];
+    size_t size = std::min<size_t>(64, telegram.size() - offset);
+    while (size > 0) {
+      Frame frame;
+      const size_t consumed = framer.next(chunk, size, frame);
+      chunk += consumed;
+      size -= consumed;
+      if (frame.start) {
+        parser.begin(buffer.data(), buffer.size());
+      }
+      parser.feed(frame.data, frame.size);
+      if (frame.end) {
+        results.push_back(parser.finish());
+      }
+    }
+  }
+  ASSERT_EQ(results.size(), 1U);
+  ASSERT_EQ(results[0].status, Status::OK);
+  EXPECT_THAT(results[0], ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"KFM5KAIFA-METER"}),
+                                      ObjectLike(ENERGY_IMPORTED_TARIFF1, std::vector<const char *>{"004180.384*kWh"}),
+                                      ObjectLike(POWER_IMPORTED, std::vector<const char *>{"00.386*kW"})));
+
+  // Without the filter the parsed telegram does not fit, which is reported rather than writing past the buffer
+  parser.set_filter(nullptr, 0);
+  parser.begin(buffer.data(), buffer.size());
+  EXPECT_EQ(parser.feed(telegram.data(), telegram.size()), Status::WRITE_OVERFLOW);
+}
+
+TEST(CompactEncodingCorpusTest, SameObjectsInLessSpace) {
+  for (const char *name : testing::TELEGRAM_CORPUS) {
+    const std::string telegram = testing::load_telegram(name);
+    ASSERT_FALSE(telegram.empty()) << name;
+
+    Parser parser;
+    std::string padded = telegram;
+    const auto padded_result = parser.parse_telegram(padded.data(), padded.size());
+    ASSERT_EQ(padded_result.status, Status::OK) << name;
+
+    parser.set_encoding(Encoding::COMPACT);
+    std::string compact = telegram;
+    const auto compact_result = parser.parse_telegram(compact.data(), compact.size());
+    ASSERT_EQ(compact_result.status, Status::OK) << name;
+    EXPECT_EQ(objects(compact_result), objects(padded_result)) << name;
+
+    // Streamed into a buffer that is just large enough for the compact output
+    size_t compact_size = 0;
+    for (const auto &object : compact_result) {
+      compact_size = object.data().data() + object.data().size() - compact.data();
+    }
+    std::vector<char> buffer(compact_size);
+    parser.begin(buffer.data(), buffer.size());
+    parser.feed(telegram.data(), telegram.size());
+    const auto streamed_result = parser.finish();
+    ASSERT_EQ(streamed_result.status, Status::OK) << name;
+    EXPECT_EQ(objects(streamed_result), objects(padded_result)) << name;
+
+    // The padded output does not fit
+    parser.set_encoding(Encoding::PADDED);
+    parser.begin(buffer.data(), buffer.size());
+    EXPECT_EQ(parser.feed(telegram.data(), telegram.size()), Status::WRITE_OVERFLOW) << name;
+  }
+}
+
+}  // namespace
+}  // namespace esphome::efs
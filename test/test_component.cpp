@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "components/efs/crc16.h"
+#include "components/efs/efs.h"
+
+using ::testing::ElementsAre;
+
+namespace esphome::efs {
+namespace {
+
+// A telegram with the energy and power objects and a correct checksum
+std::string make_telegram(const std::string &energy, const std::string &power) {
+  const std::string telegram = "/XYZ5\r\n\r\n1-0:1.8.1(" + energy + "*kWh)\r\n1-0:1.7.0(" + power + "*kW)\r\n!";
+  Crc16Calculator crc_calculator;
+  crc_calculator.update(telegram.data(), telegram.size());
+  char crc[5];
+  std::snprintf(crc, sizeof(crc), "%04X", crc_calculator.crc());
+  return telegram + crc + "\r\n";
+}
+
+class EfsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    efs_.set_max_telegram_length(1500);
+    efs_.set_request_interval(0);
+    efs_.set_receive_timeout(200);
+    efs_.add_sensor(ENERGY_IMPORTED_TARIFF1, &energy_, 3);
+    efs_.add_sensor(POWER_IMPORTED, &power_, 3);
+  }
+
+  // The main loop runs every millisecond, or more often while a telegram is received
+  void run_loop(int num_loops, uint32_t interval_us = 1000) {
+    for (int i = 0; i < num_loops; ++i) {
+      esphome::testing::now_us += interval_us;
+      efs_.loop();
+    }
+  }
+
+  uart::UARTComponent uart_;
+  Efs efs_{&uart_};
+  sensor::Sensor energy_;
+  sensor::Sensor power_;
+};
+
+TEST_F(EfsTest, TelegramsInOneChunk) {
+  efs_.setup();
+  // The second telegram is in the rest of the chunk in which the first one ends
+  const std::string data = make_telegram("1.000", "0.5") + make_telegram("2.000", "1.5");
+  ASSERT_LE(data.size(), UART_CHUNK_SIZE);
+  uart_.receive(data);
+  run_loop(2);
+  EXPECT_EQ(energy_.num_published, 2U);
+  EXPECT_FLOAT_EQ(energy_.state, 2.0f);
+  EXPECT_FLOAT_EQ(power_.state, 1.5f);
+}
+
+TEST_F(EfsTest, TelegramStartedInRestOfChunkIsCompleted) {
+  efs_.setup();
+  const std::string second = make_telegram("2.000", "1.5");
+  uart_.receive(make_telegram("1.000", "0.5") + second.substr(0, 20));
+  run_loop(1);
+  EXPECT_EQ(energy_.num_published, 1U);
+  // The rest of the second telegram arrives within the receive timeout
+  run_loop(50);
+  uart_.receive(second.substr(20));
+  run_loop(1);
+  EXPECT_EQ(energy_.num_published, 2U);
+  EXPECT_FLOAT_EQ(energy_.state, 2.0f);
+}
+
+TEST_F(EfsTest, NextTelegramIsReceivedWhileDispatching) {
+  efs_.set_double_buffer(true);
+  efs_.set_loop_budget(100);
+  efs_.setup();
+  // Publishing takes the whole loop budget, so one object is dispatched per loop
+  std::vector<float> published;
+  const auto publish = [&published](float state) {
+    published.push_back(state);
+    esphome::testing::now_us += 100;
+  };
+  energy_.add_on_state_callback(publish);
+  power_.add_on_state_callback(publish);
+  // The next telegram is already in the UART RX buffer
+  uart_.receive(make_telegram("1.000", "2.0") + make_telegram("3.000", "4.0"));
+
+  run_loop(1, 100);
+  EXPECT_THAT(published, ElementsAre(1.0f));
+  // Within the same millisecond, the second telegram is received before the first one has been dispatched. The rest
+  // of the first one is then dispatched, the identification of the second one takes the rest of the loop.
+  run_loop(1, 100);
+  EXPECT_THAT(published, ElementsAre(1.0f, 2.0f));
+  run_loop(2, 100);
+  EXPECT_THAT(published, ElementsAre(1.0f, 2.0f, 3.0f, 4.0f));
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -48,5 +48,65 @@ TEST_F(Crc16CalculatorTest, MultipleChars) {
   EXPECT_EQ(calc_.crc(), 0xFA4D);
 }
 
+TEST_F(Crc16CalculatorTest, BulkUpdate) {
+  std::string test_str = "Hello, World!";
+  calc_.update(test_str.data(), test_str.size());
+  EXPECT_EQ(calc_.crc(), 0xFA4D);
+}
+
+// Test that the sliced bulk update matches the per byte update
+template<typename T> class SlicedCrc16CalculatorTest : public ::testing::Test {};
+
+using SliceCounts = ::testing::Types<BaseCrc16Calculator<1>, BaseCrc16Calculator<2>, BaseCrc16Calculator<4>,
+                                     BaseCrc16Calculator<8>, Fcs16Calculator>;
+TYPED_TEST_SUITE(SlicedCrc16CalculatorTest, SliceCounts);
+
+TYPED_TEST(SlicedCrc16CalculatorTest, BulkUpdateMatchesPerByteUpdate) {
+  std::string data;
+  for (int i = 0; i < 300; ++i) {
+    data.push_back(static_cast<char>(i * 37 + 11));
+  }
+
+  for (size_t size = 0; size <= data.size(); ++size) {
+    TypeParam bulk;
+    TypeParam per_byte;
+    // Split the update in two to exercise unaligned starts and tails
+    const size_t split = size / 3;
+    bulk.update(data.data(), split);
+    bulk.update(data.data() + split, size - split);
+    for (size_t i = 0; i < size; ++i) {
+      per_byte.update(data[i]);
+    }
+    EXPECT_EQ(bulk.crc(), per_byte.crc()) << "size " << size;
+  }
+}
+
+// Test calculation of the FCS-16 of HDLC frames
+TEST(Fcs16CalculatorTest, CheckValue) {
+  Fcs16Calculator calc;
+  EXPECT_EQ(calc.crc(), 0xFFFF);
+  calc.update("123456789", 9);
+  // The CRC-16/X.25 check value is the complemented register
+  EXPECT_EQ(static_cast<uint16_t>(~calc.crc()), 0x906E);
+}
+
+TEST(Fcs16CalculatorTest, GoodFrameResidue) {
+  std::string frame = "\xA0\x0A\xCE\xFF\x03\x13";
+  Fcs16Calculator calc;
+  calc.update(frame.data(), frame.size());
+  const auto fcs = static_cast<uint16_t>(~calc.crc());
+  frame.push_back(static_cast<char>(fcs & 0xFF));
+  frame.push_back(static_cast<char>(fcs >> 8));
+
+  calc.reset();
+  calc.update(frame.data(), frame.size());
+  EXPECT_EQ(calc.crc(), FCS16_GOOD);
+
+  frame[2] ^= 0x01;
+  calc.reset();
+  calc.update(frame.data(), frame.size());
+  EXPECT_NE(calc.crc(), FCS16_GOOD);
+}
+
 }  // namespace
 }  // namespace esphome::efs
@@ -0,0 +1,244 @@
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "components/efs/dlms_parser.h"
+#include "components/efs/obis_code.h"
+#include "components/efs/object.h"
+#include "components/efs/result.h"
+#include "matchers.h"
+#include "telegram_corpus.h"
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Matcher;
+using esphome::efs::testing::ObjectLike;
+
+namespace esphome::efs {
+namespace {
+
+Matcher<Object> match_object(ObisCode obis_code, std::vector<const char *> values) {
+  return ObjectLike(obis_code, std::move(values));
+}
+
+const std::array<Matcher<Object>, 15> EXPECTED_OUTPUT{
+    match_object({0, 0, 0, 0, 0}, {""}),
+    match_object({0, 0, 1, 0, 0}, {"240314134530W"}),
+    match_object({0, 0, 96, 1, 0}, {"1KFM0200201234"}),
+    match_object({1, 0, 32, 7, 0}, {"230.1*V"}),
+    match_object({1, 0, 52, 7, 0}, {"229.8*V"}),
+    match_object({1, 0, 72, 7, 0}, {"231.0*V"}),
+    match_object({1, 0, 31, 7, 0}, {"1.25*A"}),
+    match_object({1, 0, 51, 7, 0}, {"0.48*A"}),
+    match_object({1, 0, 71, 7, 0}, {"3.01*A"}),
+    match_object({1, 0, 1, 7, 0}, {"1.234*kW"}),
+    match_object({1, 0, 2, 7, 0}, {"0.000*kW"}),
+    match_object({1, 0, 1, 8, 0}, {"12345.678*kWh"}),
+    match_object({1, 0, 2, 8, 0}, {"2.345*kWh"}),
+    match_object({1, 0, 3, 8, 0}, {"987.654*kvarh"}),
+    match_object({1, 0, 4, 8, 0}, {"0.012*kvarh"})};
+
+std::vector<uint8_t> load_apdu() {
+  const std::string apdu = testing::load_telegram("at_kaifa_dlms.bin");
+  return std::vector<uint8_t>(apdu.begin(), apdu.end());
+}
+
+std::vector<uint8_t> make_apdu(const std::vector<uint8_t> &body) {
+  std::vector<uint8_t> apdu{dlms::DATA_NOTIFICATION, 0x00, 0x00, 0x00, 0x01, 0x00};
+  apdu.insert(apdu.end(), body.begin(), body.end());
+  return apdu;
+}
+
+class DlmsParserTest : public ::testing::Test {
+ protected:
+  DlmsParser parser_;
+  alignas(2) char buffer_[1024];
+};
+
+TEST_F(DlmsParserTest, ParsesPushApdu) {
+  const auto apdu = load_apdu();
+  ASSERT_FALSE(apdu.empty());
+  const auto result = parser_.parse(apdu.data(), apdu.size(), buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAreArray(EXPECTED_OUTPUT));
+}
+
+TEST_F(DlmsParserTest, ParsesPushApduInPlace) {
+  const auto apdu = load_apdu();
+  ASSERT_FALSE(apdu.empty());
+  std::memcpy(buffer_, apdu.data(), apdu.size());
+  const auto result = parser_.parse_in_place(buffer_, 512, apdu.size());
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAreArray(EXPECTED_OUTPUT));
+}
+
+TEST_F(DlmsParserTest, InPlaceOverflowIsDetected) {
+  // The hex text of a binary octet string is twice its size and overtakes the unread APDU
+  std::vector<uint8_t> body{dlms::STRUCTURE, 2, dlms::OCTET_STRING, 6, 0, 0, 96, 1, 1, 255, dlms::OCTET_STRING, 32};
+  body.resize(body.size() + 32, 0x01);
+  const auto apdu = make_apdu(body);
+  std::memcpy(buffer_, apdu.data(), apdu.size());
+  EXPECT_EQ(parser_.parse_in_place(buffer_, apdu.size(), apdu.size()).status, Status::WRITE_OVERFLOW);
+  std::memcpy(buffer_, apdu.data(), apdu.size());
+  EXPECT_EQ(parser_.parse_in_place(buffer_, 2 * apdu.size(), apdu.size()).status, Status::OK);
+}
+
+TEST_F(DlmsParserTest, InPlaceWithLittleRoomKeepsUnreadBytes) {
+  // The text of the energy values is longer than their encoding, so the output catches up with the APDU just as the
+  // OBIS code and date-time of the clock are read
+  const auto apdu = make_apdu({dlms::STRUCTURE, 7,
+                               // 1-0:1.8.0 = 4000000000
+                               dlms::OCTET_STRING, 6, 1, 0, 1, 8, 0, 255, dlms::DOUBLE_LONG_UNSIGNED, 0xEE, 0x6B, 0x28,
+                               0x00,
+                               // 1-0:2.8.0 = 4000000000
+                               dlms::OCTET_STRING, 6, 1, 0, 2, 8, 0, 255, dlms::DOUBLE_LONG_UNSIGNED, 0xEE, 0x6B, 0x28,
+                               0x00,
+                               // 0-0:1.0.0 = 2024-03-14 13:45:30
+                               dlms::OCTET_STRING, 6, 0, 0, 1, 0, 0, 255, dlms::OCTET_STRING, 12, 0x07, 0xE8, 3, 14, 4,
+                               13, 45, 30, 0, 0xFF, 0xC4, 0x00,
+                               // A value without an OBIS code
+                               dlms::LONG64, 0, 0, 0, 0, 0, 0, 0, 1});
+  const auto expected = ElementsAre(match_object({0, 0, 0, 0, 0}, {""}), match_object({1, 0, 1, 8, 0}, {"4000000000"}),
+                                    match_object({1, 0, 2, 8, 0}, {"4000000000"}),
+                                    match_object({0, 0, 1, 0, 0}, {"240314134530W"}));
+  bool parsed = false;
+  for (size_t slack = 0; slack <= 16; ++slack) {
+    std::memcpy(buffer_, apdu.data(), apdu.size());
+    const auto result = parser_.parse_in_place(buffer_, apdu.size() + slack, apdu.size());
+    // Too little room must be detected rather than overwriting bytes which are needed later
+    if (result.status != Status::WRITE_OVERFLOW) {
+      ASSERT_EQ(result.status, Status::OK) << slack;
+      EXPECT_THAT(result, expected) << slack;
+      parsed = true;
+    }
+  }
+  EXPECT_TRUE(parsed);
+}
+
+TEST_F(DlmsParserTest, DecodedValuesMatchText) {
+  const auto apdu = load_apdu();
+  const auto result = parser_.parse(apdu.data(), apdu.size(), buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+  const auto energy = result.find(ObisCode(1, 0, 1, 8, 0));
+  ASSERT_TRUE(energy.has_value());
+  const auto value = energy->numeric();
+  ASSERT_TRUE(value.has_value());
+  EXPECT_EQ(value->mantissa, 12345678);
+  EXPECT_EQ(value->scale, -3);
+  EXPECT_EQ(value->unit, Unit::KWH);
+  const auto clock = result.find(ObisCode(0, 0, 1, 0, 0));
+  ASSERT_TRUE(clock.has_value());
+  EXPECT_TRUE(clock->timestamp().has_value());
+}
+
+TEST_F(DlmsParserTest, FilterAndIndex) {
+  const std::array<ObisCode, 2> filter{ObisCode(1, 0, 1, 7, 0), ObisCode(1, 0, 32, 7, 0)};
+  parser_.set_filter(filter.data(), filter.size());
+  parser_.set_index(true);
+  const auto apdu = load_apdu();
+  const auto result = parser_.parse(apdu.data(), apdu.size(), buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAre(EXPECTED_OUTPUT[0], EXPECTED_OUTPUT[3], EXPECTED_OUTPUT[9]));
+  const auto power = result.find(ObisCode(1, 0, 1, 7, 0));
+  ASSERT_TRUE(power.has_value());
+  EXPECT_EQ(std::get<0>(*power->begin()), std::string("1.234*kW"));
+}
+
+TEST_F(DlmsParserTest, NestedStructuresAndSignedValues) {
+  // An array of structures of OBIS code, value and scaler-unit
+  const auto apdu = make_apdu({dlms::ARRAY, 2,
+                               // 1-0:16.7.0 = -1500 W
+                               dlms::STRUCTURE, 3, dlms::OCTET_STRING, 6, 1, 0, 16, 7, 0, 255, dlms::DOUBLE_LONG, 0xFF,
+                               0xFF, 0xFA, 0x24, dlms::STRUCTURE, 2, dlms::INTEGER, 0, dlms::ENUM, 27,
+                               // 0-0:96.14.0 = 2, without scaler and unit
+                               dlms::STRUCTURE, 2, dlms::OCTET_STRING, 6, 0, 0, 96, 14, 0, 255, dlms::UNSIGNED, 2});
+  const auto result = parser_.parse(apdu.data(), apdu.size(), buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAre(match_object({0, 0, 0, 0, 0}, {""}), match_object({1, 0, 16, 7, 0}, {"-1.500*kW"}),
+                                  match_object({0, 0, 96, 14, 0}, {"2"})));
+}
+
+TEST_F(DlmsParserTest, BinaryOctetStringIsWrittenAsHex) {
+  const auto apdu = make_apdu({dlms::STRUCTURE, 2, dlms::OCTET_STRING, 6, 0, 0, 96, 1, 1, 255, dlms::OCTET_STRING, 3,
+                               0x01, 0xAB, 0xFF});
+  const auto result = parser_.parse(apdu.data(), apdu.size(), buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAre(match_object({0, 0, 0, 0, 0}, {""}), match_object({0, 0, 96, 1, 1}, {"01ABFF"})));
+}
+
+TEST_F(DlmsParserTest, ValuesWithoutObisCodeAreSkipped) {
+  const auto apdu = make_apdu({dlms::STRUCTURE, 3, dlms::LONG_UNSIGNED, 0x01, 0x02, dlms::OCTET_STRING, 6, 1, 0, 1, 8,
+                               0, 255, dlms::LONG64_UNSIGNED, 0, 0, 0, 0, 0, 0, 0, 42});
+  const auto result = parser_.parse(apdu.data(), apdu.size(), buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAre(match_object({0, 0, 0, 0, 0}, {""}), match_object({1, 0, 1, 8, 0}, {"42"})));
+}
+
+TEST_F(DlmsParserTest, InvalidApdus) {
+  const std::vector<uint8_t> not_a_notification{0x0E, 0x00, 0x00, 0x00, 0x01, 0x00, dlms::NULL_DATA};
+  EXPECT_EQ(parser_.parse(not_a_notification.data(), not_a_notification.size(), buffer_, sizeof(buffer_)).status,
+            Status::START_NOT_FOUND);
+  const auto truncated = make_apdu({dlms::STRUCTURE, 2, dlms::OCTET_STRING, 6, 1, 0, 1});
+  EXPECT_EQ(parser_.parse(truncated.data(), truncated.size(), buffer_, sizeof(buffer_)).status,
+            Status::PARSING_FAILED);
+  const auto floating_point = make_apdu({dlms::FLOAT32, 0, 0, 0, 0});
+  EXPECT_EQ(parser_.parse(floating_point.data(), floating_point.size(), buffer_, sizeof(buffer_)).status,
+            Status::PARSING_FAILED);
+  std::vector<uint8_t> too_deep;
+  for (int i = 0; i < 10; ++i) {
+    too_deep.insert(too_deep.end(), {dlms::STRUCTURE, 1});
+  }
+  too_deep.push_back(dlms::NULL_DATA);
+  const auto too_deep_apdu = make_apdu(too_deep);
+  EXPECT_EQ(parser_.parse(too_deep_apdu.data(), too_deep_apdu.size(), buffer_, sizeof(buffer_)).status,
+            Status::PARSING_FAILED);
+}
+
+TEST_F(DlmsParserTest, SmallBufferOverflows) {
+  const auto apdu = load_apdu();
+  const auto result = parser_.parse(apdu.data(), apdu.size(), buffer_, 64);
+  EXPECT_EQ(result.status, Status::WRITE_OVERFLOW);
+}
+
+TEST(CipheredApduTest, SplitsGeneralGloCiphering) {
+  std::string frame = testing::load_telegram("lu_smarty_encrypted.bin");
+  ASSERT_EQ(frame.size(), 573U);
+  auto *apdu = reinterpret_cast<uint8_t *>(frame.data());
+  dlms::CipheredApdu parts;
+  ASSERT_TRUE(dlms::split_ciphered_apdu(apdu, frame.size(), parts));
+  EXPECT_EQ(parts.system_title, &apdu[2]);
+  EXPECT_EQ(parts.security_control, 0x30);
+  EXPECT_EQ(parts.frame_counter, &apdu[14]);
+  EXPECT_EQ(parts.ciphertext, &apdu[18]);
+  EXPECT_EQ(parts.ciphertext_size, frame.size() - 18 - 12);
+  EXPECT_EQ(parts.tag, &apdu[frame.size() - 12]);
+
+  // Without authentication there is no tag
+  apdu[13] = dlms::SECURITY_ENCRYPTED;
+  ASSERT_TRUE(dlms::split_ciphered_apdu(apdu, frame.size(), parts));
+  EXPECT_EQ(parts.ciphertext_size, frame.size() - 18);
+  EXPECT_EQ(parts.tag, nullptr);
+
+  // The length must match the size of the APDU
+  EXPECT_FALSE(dlms::split_ciphered_apdu(apdu, frame.size() - 1, parts));
+  EXPECT_FALSE(dlms::split_ciphered_apdu(apdu, 12, parts));
+}
+
+TEST(CipheredApduTest, ShortLengthForm) {
+  std::vector<uint8_t> apdu{dlms::GENERAL_GLO_CIPHERING, 8, 1, 2, 3, 4, 5, 6, 7, 8, 7, 0x20, 0, 0, 0, 1, 0xAA, 0xBB};
+  dlms::CipheredApdu parts;
+  ASSERT_TRUE(dlms::split_ciphered_apdu(apdu.data(), apdu.size(), parts));
+  EXPECT_EQ(parts.ciphertext, &apdu[16]);
+  EXPECT_EQ(parts.ciphertext_size, 2U);
+  EXPECT_EQ(parts.tag, nullptr);
+  // Too short for the authentication tag
+  apdu[11] = 0x30;
+  EXPECT_FALSE(dlms::split_ciphered_apdu(apdu.data(), apdu.size(), parts));
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "components/efs/framer.h"
+#include "telegram_corpus.h"
+
+namespace esphome::efs {
+namespace {
+
+/// A UART which delivers data in bursts of at most burst_size bytes and counts the calls made to it.
+class FakeUart {
+ public:
+  FakeUart(std::string data, size_t burst_size) : data_(std::move(data)), burst_size_(burst_size) {}
+
+  int available() {
+    ++available_calls;
+    return static_cast<int>(std::min(data_.size() - pos_, burst_size_));
+  }
+
+  int read() {
+    ++read_calls;
+    return pos_ < data_.size() ? static_cast<uint8_t>(data_[pos_++]) : -1;
+  }
+
+  bool read_array(uint8_t *data, size_t size) {
+    ++read_array_calls;
+    if (size > data_.size() - pos_) {
+      return false;
+    }
+    std::memcpy(data, &data_[pos_], size);
+    pos_ += size;
+    return true;
+  }
+
+  size_t available_calls{0};
+  size_t read_calls{0};
+  size_t read_array_calls{0};
+
+ private:
+  std::string data_;
+  size_t burst_size_;
+  size_t pos_{0};
+};
+
+/// Split data into chunks of chunk_size bytes and return the telegrams found by framer.
+template<typename Framer> std::vector<std::string> frame_telegrams(const std::string &data, size_t chunk_size) {
+  Framer framer;
+  std::vector<std::string> telegrams;
+  std::string current;
+  for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+    const char *chunk = &data[offset];
+    size_t size = std::min(chunk_size, data.size() - offset);
+    while (size > 0) {
+      Frame frame;
+      const size_t consumed = framer.next(chunk, size, frame);
+      EXPECT_GT(consumed, 0U);
+      chunk += consumed;
+      size -= consumed;
+      if (frame.start) {
+        current.clear();
+      }
+      current.append(frame.data, frame.size);
+      if (frame.end) {
+        telegrams.push_back(current);
+        current.clear();
+      }
+    }
+  }
+  return telegrams;
+}
+
+class FramerCorpusTest : public ::testing::TestWithParam<const char *> {};
+
+TEST_P(FramerCorpusTest, FramesTelegramSplitIntoChunks) {
+  const std::string telegram = testing::load_telegram(GetParam());
+  ASSERT_FALSE(telegram.empty());
+  if (telegram.find('!') == std::string::npos) {
+    GTEST_SKIP() << "Telegram has no footer";
+  }
+  const std::string data = "noise\r\n" + telegram + telegram + "/partial";
+  for (const size_t chunk_size : {1, 7, 64, 1024}) {
+    const auto telegrams = frame_telegrams<TelegramFramer>(data, chunk_size);
+    ASSERT_EQ(telegrams.size(), 2U) << chunk_size;
+    EXPECT_EQ(telegrams[0], telegram) << chunk_size;
+    EXPECT_EQ(telegrams[1], telegram) << chunk_size;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Corpus, FramerCorpusTest, ::testing::ValuesIn(testing::TELEGRAM_CORPUS));
+
+TEST(TelegramFramerTest, SlashRestartsTelegram) {
+  const std::string data = "/ABC5\r\n1-0:1.8.1(0\r\n/XYZ5\r\n\r\n!1234\r\n";
+  for (const size_t chunk_size : {1, 5, 100}) {
+    const auto telegrams = frame_telegrams<TelegramFramer>(data, chunk_size);
+    ASSERT_EQ(telegrams.size(), 1U) << chunk_size;
+    EXPECT_EQ(telegrams[0], "/XYZ5\r\n\r\n!1234\r\n") << chunk_size;
+  }
+}
+
+TEST(TelegramFramerTest, ResetDiscardsTelegram) {
+  TelegramFramer framer;
+  Frame frame;
+  const std::string start = "/ABC5\r\n";
+  EXPECT_EQ(framer.next(start.data(), start.size(), frame), start.size());
+  EXPECT_TRUE(frame.start);
+  framer.reset();
+  const std::string rest = "!1234\r\n";
+  EXPECT_EQ(framer.next(rest.data(), rest.size(), frame), rest.size());
+  EXPECT_FALSE(frame.start);
+  EXPECT_FALSE(frame.end);
+  EXPECT_EQ(frame.size, 0U);
+}
+
+TEST(EncryptedTelegramFramerTest, FramesTelegramByLength) {
+  const std::string telegram = testing::load_telegram("lu_smarty_encrypted.bin");
+  ASSERT_EQ(telegram.size(), 573U);
+  const std::string data = std::string("\x01\x02", 2) + telegram + telegram;
+  for (const size_t chunk_size : {1, 11, 13, 64, 1024}) {
+    const auto telegrams = frame_telegrams<EncryptedTelegramFramer>(data, chunk_size);
+    ASSERT_EQ(telegrams.size(), 2U) << chunk_size;
+    EXPECT_EQ(telegrams[0], telegram) << chunk_size;
+    EXPECT_EQ(telegrams[1], telegram) << chunk_size;
+  }
+}
+
+TEST(EncryptedTelegramFramerTest, TelegramSizeIsKnownAfterHeader) {
+  const std::string telegram = testing::load_telegram("lu_smarty_encrypted.bin");
+  ASSERT_EQ(telegram.size(), 573U);
+  EncryptedTelegramFramer framer;
+  Frame frame;
+  framer.next(telegram.data(), EncryptedTelegramFramer::HEADER_SIZE - 1, frame);
+  EXPECT_EQ(framer.telegram_size(), 0U);
+  framer.next(&telegram[EncryptedTelegramFramer::HEADER_SIZE - 1], 1, frame);
+  EXPECT_EQ(framer.telegram_size(), telegram.size());
+  const size_t rest = telegram.size() - EncryptedTelegramFramer::HEADER_SIZE;
+  EXPECT_EQ(framer.next(&telegram[EncryptedTelegramFramer::HEADER_SIZE], rest, frame), rest);
+  EXPECT_TRUE(frame.end);
+  // The size is kept until the next telegram starts
+  EXPECT_EQ(framer.telegram_size(), telegram.size());
+}
+
+TEST(DrainUartTest, ReadsInChunks) {
+  const std::string telegram = testing::load_telegram("dsmr5_kaifa.txt");
+  ASSERT_FALSE(telegram.empty());
+  FakeUart uart(telegram, 64);
+  uint8_t buffer[128];
+  std::string received;
+  const size_t size = drain_uart(uart, buffer, sizeof(buffer), [&received](const char *chunk, size_t size) {
+    received.append(chunk, size);
+    return true;
+  });
+  EXPECT_EQ(size, telegram.size());
+  EXPECT_EQ(received, telegram);
+  EXPECT_EQ(uart.read_calls, 0U);
+  EXPECT_EQ(uart.read_array_calls, (telegram.size() + 63) / 64);
+  EXPECT_EQ(uart.available_calls, uart.read_array_calls + 1);
+}
+
+TEST(DrainUartTest, ReadsAtMostBufferSize) {
+  FakeUart uart(std::string(1000, 'x'), 1000);
+  uint8_t buffer[128];
+  drain_uart(uart, buffer, sizeof(buffer), [](const char *, size_t size) { return size <= 128; });
+  EXPECT_EQ(uart.read_array_calls, 8U);
+}
+
+TEST(DrainUartTest, StopsWhenCallbackReturnsFalse) {
+  FakeUart uart(std::string(1000, 'x'), 1000);
+  uint8_t buffer[100];
+  const size_t size = drain_uart(uart, buffer, sizeof(buffer), [](const char *, size_t) { return false; });
+  EXPECT_EQ(size, 100U);
+  EXPECT_EQ(uart.read_array_calls, 1U);
+  EXPECT_EQ(uart.available(), 900);
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,128 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "components/efs/gcm.h"
+#include "telegram_corpus.h"
+
+namespace esphome::efs {
+namespace {
+
+std::vector<uint8_t> from_hex(const std::string &hex) {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+    bytes.push_back(static_cast<uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+/// Decrypt ciphertext in chunks of chunk_size bytes, returns false if the tag does not match.
+bool decrypt(Gcm &gcm, const std::vector<uint8_t> &iv, const std::vector<uint8_t> &aad,
+             const std::vector<uint8_t> &ciphertext, const std::vector<uint8_t> &tag, size_t chunk_size,
+             std::vector<uint8_t> &plaintext) {
+  plaintext.assign(ciphertext.size() + Gcm::MAX_HELD_BACK, 0);
+  EXPECT_TRUE(gcm.start(iv.data(), iv.size(), aad.data(), aad.size()));
+  size_t written = 0;
+  for (size_t offset = 0; offset < ciphertext.size(); offset += chunk_size) {
+    const size_t size = std::min(chunk_size, ciphertext.size() - offset);
+    written += gcm.decrypt(&ciphertext[offset], size, &plaintext[written]);
+    EXPECT_LE(offset + size - written, Gcm::MAX_HELD_BACK);
+  }
+  const int rest = gcm.finish(&plaintext[written], tag.data(), tag.size());
+  if (rest < 0) {
+    return false;
+  }
+  plaintext.resize(written + rest);
+  return true;
+}
+
+// Test case 4 of the GCM specification, AES-128 with additional authenticated data
+const auto KAT_KEY = from_hex("feffe9928665731c6d6a8f9467308308");
+const auto KAT_IV = from_hex("cafebabefacedbaddecaf888");
+const auto KAT_AAD = from_hex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+const auto KAT_PLAINTEXT = from_hex(
+    "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de6"
+    "57ba637b39");
+const auto KAT_CIPHERTEXT = from_hex(
+    "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac"
+    "973d58e091");
+const auto KAT_TAG = from_hex("5bc94fbc3221a5db94fae95ae7121a47");
+
+TEST(GcmTest, KnownAnswerInChunks) {
+  Gcm gcm;
+  ASSERT_TRUE(gcm.set_key(KAT_KEY.data(), KAT_KEY.size()));
+  for (const size_t chunk_size : {1, 7, 16, 17, 64}) {
+    std::vector<uint8_t> plaintext;
+    ASSERT_TRUE(decrypt(gcm, KAT_IV, KAT_AAD, KAT_CIPHERTEXT, KAT_TAG, chunk_size, plaintext)) << chunk_size;
+    EXPECT_EQ(plaintext, KAT_PLAINTEXT) << chunk_size;
+  }
+}
+
+TEST(GcmTest, TruncatedTag) {
+  Gcm gcm;
+  ASSERT_TRUE(gcm.set_key(KAT_KEY.data(), KAT_KEY.size()));
+  const std::vector<uint8_t> tag(KAT_TAG.begin(), KAT_TAG.begin() + 12);
+  std::vector<uint8_t> plaintext;
+  EXPECT_TRUE(decrypt(gcm, KAT_IV, KAT_AAD, KAT_CIPHERTEXT, tag, 16, plaintext));
+}
+
+TEST(GcmTest, CorruptedCiphertextFailsTag) {
+  Gcm gcm;
+  ASSERT_TRUE(gcm.set_key(KAT_KEY.data(), KAT_KEY.size()));
+  auto ciphertext = KAT_CIPHERTEXT;
+  ciphertext[10] ^= 0x01;
+  std::vector<uint8_t> plaintext;
+  EXPECT_FALSE(decrypt(gcm, KAT_IV, KAT_AAD, ciphertext, KAT_TAG, 16, plaintext));
+}
+
+TEST(GcmTest, WrongAadFailsTag) {
+  Gcm gcm;
+  ASSERT_TRUE(gcm.set_key(KAT_KEY.data(), KAT_KEY.size()));
+  std::vector<uint8_t> plaintext;
+  EXPECT_FALSE(decrypt(gcm, KAT_IV, {}, KAT_CIPHERTEXT, KAT_TAG, 16, plaintext));
+}
+
+TEST(GcmTest, DecryptInPlace) {
+  Gcm gcm;
+  ASSERT_TRUE(gcm.set_key(KAT_KEY.data(), KAT_KEY.size()));
+  // APDUs received in HDLC frames are decrypted in the telegram buffer
+  auto buffer = KAT_CIPHERTEXT;
+  ASSERT_TRUE(gcm.start(KAT_IV.data(), KAT_IV.size(), KAT_AAD.data(), KAT_AAD.size()));
+  const size_t written = gcm.decrypt(buffer.data(), buffer.size(), buffer.data());
+  const int rest = gcm.finish(&buffer[written], KAT_TAG.data(), KAT_TAG.size());
+  ASSERT_GE(rest, 0);
+  EXPECT_EQ(written + rest, KAT_PLAINTEXT.size());
+  EXPECT_EQ(buffer, KAT_PLAINTEXT);
+}
+
+TEST(GcmTest, EncryptedTelegram) {
+  const std::string frame = testing::load_telegram("lu_smarty_encrypted.bin");
+  ASSERT_EQ(frame.size(), 573U);
+  const std::vector<uint8_t> bytes(frame.begin(), frame.end());
+  const auto key = from_hex("000102030405060708090A0B0C0D0E0F");
+  // The IV is the system title and frame counter, the AAD the security byte and authentication key
+  std::vector<uint8_t> iv(&bytes[2], &bytes[10]);
+  iv.insert(iv.end(), &bytes[14], &bytes[18]);
+  auto aad = from_hex("30D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF");
+  const std::vector<uint8_t> ciphertext(&bytes[18], &bytes[bytes.size() - 12]);
+  const std::vector<uint8_t> tag(&bytes[bytes.size() - 12], &bytes[bytes.size()]);
+
+  Gcm gcm;
+  ASSERT_TRUE(gcm.set_key(key.data(), key.size()));
+  std::vector<uint8_t> plaintext;
+  ASSERT_TRUE(decrypt(gcm, iv, aad, ciphertext, tag, 128, plaintext));
+  EXPECT_EQ(std::string(plaintext.begin(), plaintext.end()), testing::load_telegram("lu_smarty.txt"));
+
+  // The key schedule is reused for the next telegram
+  ASSERT_TRUE(decrypt(gcm, iv, aad, ciphertext, tag, 5, plaintext));
+  EXPECT_EQ(std::string(plaintext.begin(), plaintext.end()), testing::load_telegram("lu_smarty.txt"));
+
+  aad[1] ^= 0xFF;
+  EXPECT_FALSE(decrypt(gcm, iv, aad, ciphertext, tag, 128, plaintext));
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,253 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "components/efs/dlms_parser.h"
+#include "components/efs/hdlc.h"
+#include "telegram_corpus.h"
+
+using ::testing::ElementsAre;
+
+namespace esphome::efs {
+namespace {
+
+// Bitwise FCS-16, independent of the table driven calculator
+uint16_t fcs16(const std::string &data) {
+  uint16_t fcs = 0xFFFF;
+  for (const char ch : data) {
+    fcs ^= static_cast<uint8_t>(ch);
+    for (int i = 0; i < 8; ++i) {
+      fcs = (fcs & 0x0001) != 0 ? (fcs >> 1) ^ 0x8408 : fcs >> 1;
+    }
+  }
+  return ~fcs;
+}
+
+void append_fcs(std::string &frame, size_t start) {
+  const uint16_t fcs = fcs16(frame.substr(start));
+  frame.push_back(static_cast<char>(fcs & 0xFF));
+  frame.push_back(static_cast<char>(fcs >> 8));
+}
+
+// An HDLC frame from the meter without its flags, by default a UI frame as sent by meters pushing DLMS data
+std::string make_frame(const std::string &info, bool segmented, uint8_t control = 0x13) {
+  // Format (2), destination address (1), source address (2), control (1), HCS (2), information and FCS (2)
+  const size_t frame_size = 8 + info.size() + (info.empty() ? 0 : 2);
+  std::string frame;
+  frame.push_back(static_cast<char>(0xA0 | (segmented ? 0x08 : 0x00) | (frame_size >> 8)));
+  frame.push_back(static_cast<char>(frame_size & 0xFF));
+  frame.append("\x41\x00\x03", 3);
+  frame.push_back(static_cast<char>(control));
+  append_fcs(frame, 0);
+  if (!info.empty()) {
+    frame += info;
+    append_fcs(frame, 0);
+  }
+  return frame;
+}
+
+const std::string LLC("\xE6\xE7\x00", 3);
+const std::string FLAG("\x7E");
+
+// Split apdu into frames of at most segment_size bytes, each frame with its own flags
+std::string make_frames(const std::string &apdu, size_t segment_size) {
+  std::string data;
+  std::string info = LLC + apdu;
+  for (size_t offset = 0; offset < info.size(); offset += segment_size) {
+    const bool segmented = offset + segment_size < info.size();
+    data += FLAG + make_frame(info.substr(offset, segment_size), segmented) + FLAG;
+  }
+  return data;
+}
+
+// Split apdu into I frames of at most segment_size bytes, numbered from send_sequence
+std::vector<std::string> make_i_frames(const std::string &apdu, size_t segment_size, uint8_t send_sequence) {
+  std::vector<std::string> frames;
+  std::string info = LLC + apdu;
+  for (size_t offset = 0; offset < info.size(); offset += segment_size, ++send_sequence) {
+    const bool segmented = offset + segment_size < info.size();
+    // Poll/final bit set and N(S) in bits 1-3
+    const auto control = static_cast<uint8_t>(0x10 | (send_sequence & 0x07) << 1);
+    frames.push_back(FLAG + make_frame(info.substr(offset, segment_size), segmented, control) + FLAG);
+  }
+  return frames;
+}
+
+class HdlcDeframerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { deframer_.set_buffer(buffer_, sizeof(buffer_)); }
+
+  // Scan data in chunks of chunk_size bytes, returns the events and the reassembled messages. The deframer is reset
+  // after each message if reset_after_message is set, as the component does.
+  std::vector<HdlcEvent> deframe(const std::string &data, size_t chunk_size = 128, bool reset_after_message = false) {
+    std::vector<HdlcEvent> events;
+    for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+      const char *chunk = &data[offset];
+      size_t size = std::min(chunk_size, data.size() - offset);
+      while (size > 0) {
+        HdlcEvent event;
+        const size_t consumed = deframer_.next(chunk, size, event);
+        chunk += consumed;
+        size -= consumed;
+        if (event == HdlcEvent::MESSAGE) {
+          messages_.emplace_back(deframer_.data(), deframer_.size());
+          if (reset_after_message) {
+            deframer_.reset();
+          }
+        }
+        if (event != HdlcEvent::NONE) {
+          events.push_back(event);
+        }
+      }
+    }
+    return events;
+  }
+
+  HdlcDeframer deframer_;
+  char buffer_[512];
+  std::vector<std::string> messages_;
+};
+
+TEST_F(HdlcDeframerTest, SingleFrame) {
+  const std::string apdu("\x0F\x00\x00\x00\x01\x00\x12\x00\x2A", 9);
+  EXPECT_THAT(deframe(make_frames(apdu, 128)), ElementsAre(HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(apdu));
+}
+
+TEST_F(HdlcDeframerTest, SegmentsAreReassembledInAnyChunkSize) {
+  const std::string apdu = testing::load_telegram("at_kaifa_dlms.bin");
+  ASSERT_FALSE(apdu.empty());
+  const std::string data = make_frames(apdu, 120);
+  for (const size_t chunk_size : {1, 2, 7, 64, 128, 1024}) {
+    messages_.clear();
+    EXPECT_THAT(deframe(data, chunk_size), ElementsAre(HdlcEvent::START, HdlcEvent::MESSAGE)) << chunk_size;
+    EXPECT_THAT(messages_, ElementsAre(apdu)) << chunk_size;
+  }
+}
+
+TEST_F(HdlcDeframerTest, SharedAndIdleFlags) {
+  const std::string first("\x0F\x01", 2);
+  const std::string second("\x0F\x02", 2);
+  // Frames which share a flag, followed by idle flags and leading noise
+  const std::string data = "noise" + FLAG + make_frame(LLC + first, false) + FLAG + make_frame(LLC + second, false) +
+                           FLAG + FLAG + FLAG + make_frame(LLC + first, false) + FLAG;
+  EXPECT_THAT(deframe(data, 5), ElementsAre(HdlcEvent::START, HdlcEvent::MESSAGE, HdlcEvent::START,
+                                            HdlcEvent::MESSAGE, HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(first, second, first));
+}
+
+TEST_F(HdlcDeframerTest, SharedFlagIsKeptByReset) {
+  const std::string first("\x0F\x01", 2);
+  const std::string second("\x0F\x02", 2);
+  const std::string data = FLAG + make_frame(LLC + first, false) + FLAG + make_frame(LLC + second, false) + FLAG;
+  for (const size_t chunk_size : {1, 5, 128}) {
+    messages_.clear();
+    EXPECT_THAT(deframe(data, chunk_size, true),
+                ElementsAre(HdlcEvent::START, HdlcEvent::MESSAGE, HdlcEvent::START, HdlcEvent::MESSAGE))
+        << chunk_size;
+    EXPECT_THAT(messages_, ElementsAre(first, second)) << chunk_size;
+  }
+}
+
+TEST_F(HdlcDeframerTest, SequencedSegmentsAreReassembled) {
+  const std::string apdu = testing::load_telegram("at_kaifa_dlms.bin");
+  ASSERT_FALSE(apdu.empty());
+  // The send sequence number wraps around after 7
+  std::string data;
+  for (const auto &frame : make_i_frames(apdu, 40, 5)) {
+    data += frame;
+  }
+  EXPECT_THAT(deframe(data), ElementsAre(HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(apdu));
+}
+
+TEST_F(HdlcDeframerTest, LostSegmentDropsMessage) {
+  const std::string apdu = testing::load_telegram("at_kaifa_dlms.bin");
+  auto frames = make_i_frames(apdu, 120, 0);
+  ASSERT_GE(frames.size(), 3U);
+  // The second segment is lost, the third one does not follow the first. The next message is received intact.
+  std::string data = frames[0];
+  for (size_t i = 2; i < frames.size(); ++i) {
+    data += frames[i];
+  }
+  for (const auto &frame : make_i_frames(apdu, 120, frames.size())) {
+    data += frame;
+  }
+  const auto events = deframe(data);
+  ASSERT_GE(events.size(), 4U);
+  EXPECT_EQ(events[0], HdlcEvent::START);
+  EXPECT_EQ(events[1], HdlcEvent::MISSING_SEGMENT);
+  EXPECT_EQ(events[events.size() - 2], HdlcEvent::START);
+  EXPECT_EQ(events.back(), HdlcEvent::MESSAGE);
+  EXPECT_THAT(messages_, ElementsAre(apdu));
+}
+
+TEST_F(HdlcDeframerTest, FrameWithoutInformationIsIgnored) {
+  const std::string apdu("\x0F\x01", 2);
+  const std::string data = FLAG + make_frame("", false) + FLAG + make_frame(LLC + apdu, false) + FLAG;
+  EXPECT_THAT(deframe(data), ElementsAre(HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(apdu));
+}
+
+TEST_F(HdlcDeframerTest, CorruptedSegmentDropsMessage) {
+  const std::string apdu = testing::load_telegram("at_kaifa_dlms.bin");
+  std::string broken = make_frames(apdu, 120);
+  // A bit error in the information field of the second segment
+  broken[200] ^= 0x10;
+  // The remaining segment can not start a message, which is only known once it has been checked. The next message
+  // is received intact.
+  EXPECT_THAT(deframe(broken + make_frames(apdu, 120)),
+              ElementsAre(HdlcEvent::START, HdlcEvent::INVALID_FCS, HdlcEvent::START, HdlcEvent::MISSING_SEGMENT,
+                          HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(apdu));
+}
+
+TEST_F(HdlcDeframerTest, CorruptedHeaderIsRejected) {
+  const std::string apdu("\x0F\x01", 2);
+  std::string broken = FLAG + make_frame(LLC + apdu, false) + FLAG;
+  // A bit error in the frame length
+  broken[2] ^= 0x01;
+  EXPECT_THAT(deframe(broken + FLAG + make_frame(LLC + apdu, false) + FLAG),
+              ElementsAre(HdlcEvent::INVALID_FRAME, HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(apdu));
+}
+
+TEST_F(HdlcDeframerTest, MissingClosingFlag) {
+  const std::string apdu("\x0F\x01", 2);
+  EXPECT_THAT(deframe(FLAG + make_frame(LLC + apdu, false) + "x" + FLAG + make_frame(LLC + apdu, false) + FLAG),
+              ElementsAre(HdlcEvent::START, HdlcEvent::INVALID_FRAME, HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(apdu));
+}
+
+TEST_F(HdlcDeframerTest, MessageLargerThanBuffer) {
+  const std::string apdu(400, '\x42');
+  EXPECT_THAT(deframe(make_frames(apdu, 300) + make_frames(apdu, 300) + make_frames(apdu.substr(0, 10), 300)),
+              ElementsAre(HdlcEvent::START, HdlcEvent::MESSAGE, HdlcEvent::START, HdlcEvent::MESSAGE,
+                          HdlcEvent::START, HdlcEvent::MESSAGE));
+  deframer_.set_buffer(buffer_, 256);
+  messages_.clear();
+  // The last segment is left without its first segment
+  EXPECT_THAT(deframe(make_frames(apdu, 200) + make_frames(apdu.substr(0, 10), 200)),
+              ElementsAre(HdlcEvent::START, HdlcEvent::BUFFER_OVERFLOW, HdlcEvent::START, HdlcEvent::MISSING_SEGMENT,
+                          HdlcEvent::START, HdlcEvent::MESSAGE));
+  EXPECT_THAT(messages_, ElementsAre(apdu.substr(0, 10)));
+}
+
+TEST_F(HdlcDeframerTest, ReassembledApduIsParsed) {
+  const std::string apdu = testing::load_telegram("at_kaifa_dlms.bin");
+  deframe(make_frames(apdu, 64));
+  ASSERT_EQ(messages_.size(), 1U);
+  // The APDU is in the buffer, ready to be parsed in place
+  DlmsParser parser;
+  const auto result = parser.parse_in_place(buffer_, sizeof(buffer_), deframer_.size());
+  ASSERT_EQ(result.status, Status::OK);
+  const auto energy = result.find(ObisCode(1, 0, 1, 8, 0));
+  ASSERT_TRUE(energy.has_value());
+  EXPECT_EQ(std::get<0>(*energy->begin()), std::string("12345.678*kWh"));
+}
+
+}  // namespace
+}  // namespace esphome::efs
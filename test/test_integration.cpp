@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <tuple>
@@ -12,7 +13,9 @@
 #include "components/efs/parser.h"
 #include "components/efs/result.h"
 #include "matchers.h"
+#include "telegram_corpus.h"
 
+using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::Matcher;
 using esphome::efs::testing::ObjectLike;
@@ -106,5 +109,99 @@ TEST_F(IntegrationTest, TestSampleTelegramParsing) {
   EXPECT_THAT(result, ElementsAreArray(EXPECTED_OUTPUT));
 }
 
+TEST_F(IntegrationTest, TestSampleTelegramFilteredParsing) {
+  // Sorted by OBIS code
+  const std::array<ObisCode, 4> filter{ObisCode(0, 1, 24, 2, 1), ObisCode(1, 0, 1, 7, 0), ObisCode(1, 0, 1, 8, 1),
+                                       ObisCode(1, 0, 99, 99, 0)};
+  parser_.set_filter(filter.data(), filter.size());
+  const auto result = parser_.parse_telegram(buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+
+  EXPECT_THAT(result, ElementsAre(EXPECTED_OUTPUT[0], EXPECTED_OUTPUT[4], EXPECTED_OUTPUT[9], EXPECTED_OUTPUT[26]));
+}
+
+TEST_F(IntegrationTest, TestSampleTelegramIndexedLookup) {
+  parser_.set_index(true);
+  const auto result = parser_.parse_telegram(buffer_, sizeof(buffer_));
+  ASSERT_EQ(result.status, Status::OK);
+
+  EXPECT_THAT(result, ElementsAreArray(EXPECTED_OUTPUT));
+  size_t i = 0;
+  for (const auto &object : result) {
+    if (i++ == 0) {
+      continue;
+    }
+    const auto found = result.find(object.obis_code());
+    ASSERT_TRUE(found.has_value());
+    EXPECT_THAT(*found, EXPECTED_OUTPUT[i - 1]);
+  }
+  EXPECT_FALSE(result.find(ObisCode(1, 0, 99, 99, 0)).has_value());
+  EXPECT_FALSE(result.find(ObisCode(0, 0, 0, 0, 0)).has_value());
+}
+
+TEST_F(IntegrationTest, TestSampleTelegramIncrementalParsing) {
+  alignas(2) char output[1024];
+  parser_.begin(output, sizeof(output));
+  // Feed the telegram in chunks of varying size, similar to how it arrives over the UART
+  const size_t telegram_size = sizeof(SAMPLE_TELEGRAM) - 1;
+  for (size_t pos = 0, chunk_size = 1; pos < telegram_size; pos += chunk_size, chunk_size = chunk_size % 61 + 7) {
+    ASSERT_EQ(parser_.feed(&SAMPLE_TELEGRAM[pos], std::min(chunk_size, telegram_size - pos)), Status::OK);
+  }
+  const auto result = parser_.finish();
+  ASSERT_EQ(result.status, Status::OK);
+
+  EXPECT_THAT(result, ElementsAreArray(EXPECTED_OUTPUT));
+}
+
+class CorpusTest : public ::testing::TestWithParam<const char *> {};
+
+TEST_P(CorpusTest, ParsesAllObjects) {
+  auto telegram = testing::load_telegram(GetParam());
+  ASSERT_FALSE(telegram.empty());
+  // Every line starting with a digit is an object
+  size_t expected_objects = 0;
+  for (size_t pos = telegram.find('\n'); pos != std::string::npos; pos = telegram.find('\n', pos + 1)) {
+    expected_objects += pos + 1 < telegram.size() && util::is_digit(telegram[pos + 1]) ? 1 : 0;
+  }
+
+  // Incrementally, one line at a time
+  std::vector<char> output(telegram.size());
+  Parser parser;
+  parser.begin(output.data(), output.size());
+  for (size_t pos = 0, end = 0; pos < telegram.size(); pos = end) {
+    end = std::min(telegram.find('\n', pos) + 1, telegram.size());
+    ASSERT_EQ(parser.feed(&telegram[pos], end - pos), Status::OK);
+  }
+  const auto chunked_result = parser.finish();
+  ASSERT_EQ(chunked_result.status, Status::OK);
+  size_t num_objects = 0;
+  for (auto it = chunked_result.begin(); it != chunked_result.end(); ++it) {
+    ++num_objects;
+  }
+  // The identification is returned as the first object
+  EXPECT_EQ(num_objects, expected_objects + 1);
+
+  // In place
+  const auto result = parser.parse_telegram(telegram.data(), telegram.size());
+  ASSERT_EQ(result.status, Status::OK);
+  num_objects = 0;
+  for (auto it = result.begin(); it != result.end(); ++it) {
+    ++num_objects;
+  }
+  EXPECT_EQ(num_objects, expected_objects + 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(Telegrams, CorpusTest, ::testing::ValuesIn(testing::TELEGRAM_CORPUS));
+
+TEST(CorpusTest, EncryptedFrameLengthMatchesFile) {
+  const auto frame = testing::load_telegram("lu_smarty_encrypted.bin");
+  ASSERT_GT(frame.size(), 18);
+  EXPECT_EQ(static_cast<uint8_t>(frame[0]), 0xDB);
+  const size_t length = static_cast<uint8_t>(frame[11]) << 8 | static_cast<uint8_t>(frame[12]);
+  EXPECT_EQ(frame.size(), 13 + length);
+  // The ciphertext is as long as the plain text, followed by a 12 byte tag
+  EXPECT_EQ(frame.size() - 18 - 12, testing::load_telegram("lu_smarty.txt").size());
+}
+
 }  // namespace
 }  // namespace esphome::efs
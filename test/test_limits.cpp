@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "components/efs/parser.h"
+#include "components/efs/result.h"
+#include "telegram_generator.h"
+
+namespace esphome::efs {
+namespace {
+
+using testing::generate_telegram;
+using testing::generate_telegram_of_size;
+using testing::TelegramShape;
+
+struct LimitCase {
+  const char *name;
+  TelegramShape shape;
+  Status status;
+};
+
+std::ostream &operator<<(std::ostream &os, const LimitCase &limit_case) { return os << limit_case.name; }
+
+TelegramShape shape(size_t num_objects, size_t num_values, size_t value_size, size_t identification_size = 16,
+                    bool hex_values = false) {
+  return TelegramShape{num_objects, num_values, value_size, identification_size, hex_values};
+}
+
+class LimitTest : public ::testing::TestWithParam<LimitCase> {};
+
+TEST_P(LimitTest, ParsesUpToLimit) {
+  const auto &param = GetParam();
+  auto telegram = generate_telegram(param.shape);
+  Parser parser;
+  const auto result = parser.parse_telegram(telegram.data(), telegram.size());
+  ASSERT_EQ(result.status, param.status);
+  if (param.status != Status::OK) {
+    return;
+  }
+
+  size_t num_objects = 0;
+  for (auto it = result.begin(); it != result.end(); ++it, ++num_objects) {
+    if (num_objects == 0) {
+      EXPECT_EQ(std::get<1>(*it->begin()), param.shape.identification_size);
+      continue;
+    }
+    ASSERT_EQ(it->num_values(), param.shape.num_values);
+    for (const auto &value : *it) {
+      ASSERT_EQ(std::get<1>(value), param.shape.value_size);
+    }
+  }
+  EXPECT_EQ(num_objects, param.shape.num_objects + 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Generated, LimitTest,
+    ::testing::Values(LimitCase{"MaxObjects", shape(MAX_NUM_OBJECTS, 1, 10), Status::OK},
+                      LimitCase{"TooManyObjects", shape(MAX_NUM_OBJECTS + 1, 1, 10), Status::TOO_MANY_OBJECTS},
+                      LimitCase{"MaxValues", shape(1, MAX_NUM_VALUES, 10), Status::OK},
+                      LimitCase{"TooManyValues", shape(1, MAX_NUM_VALUES + 1, 10), Status::TOO_MANY_VALUES},
+                      // Header, value and NUL terminator
+                      LimitCase{"MaxObjectSize", shape(1, 1, MAX_OBJECT_SIZE - HEADER_SIZE - 1), Status::OK},
+                      LimitCase{"ObjectTooLong", shape(1, 1, MAX_OBJECT_SIZE - HEADER_SIZE), Status::OBJECT_TOO_LONG},
+                      LimitCase{"MaxSizeOfManyValues", shape(1, 16, (MAX_OBJECT_SIZE - HEADER_SIZE) / 16 - 1),
+                                Status::OK},
+                      LimitCase{"LongHexValue", shape(4, 1, MAX_OBJECT_SIZE - HEADER_SIZE - 1, 16, true), Status::OK},
+                      // Identification and NUL terminator
+                      LimitCase{"MaxHeaderSize", shape(1, 1, 10, MAX_HEADER_SIZE - 1), Status::OK},
+                      LimitCase{"HeaderTooLong", shape(1, 1, 10, MAX_HEADER_SIZE), Status::HEADER_TOO_LONG},
+                      LimitCase{"EmptyValues", shape(MAX_NUM_OBJECTS, 4, 0), Status::OK}),
+    [](const ::testing::TestParamInfo<LimitCase> &info) { return info.param.name; });
+
+class ScalingTest : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(ScalingTest, ParsesGeneratedTelegram) {
+  const auto telegram = generate_telegram_of_size(GetParam());
+  // Within 10% of the requested size
+  EXPECT_NEAR(static_cast<double>(telegram.size()), static_cast<double>(GetParam()), GetParam() * 0.1);
+
+  auto in_place = telegram;
+  Parser parser;
+  const auto result = parser.parse_telegram(in_place.data(), in_place.size());
+  ASSERT_EQ(result.status, Status::OK);
+
+  // Feeding the telegram in chunks gives the same output
+  std::vector<char> output(telegram.size());
+  parser.begin(output.data(), output.size());
+  for (size_t pos = 0; pos < telegram.size(); pos += 97) {
+    ASSERT_EQ(parser.feed(&telegram[pos], std::min<size_t>(97, telegram.size() - pos)), Status::OK);
+  }
+  const auto chunked_result = parser.finish();
+  ASSERT_EQ(chunked_result.status, Status::OK);
+
+  size_t num_objects = 0;
+  auto it = result.begin();
+  for (auto chunked_it = chunked_result.begin(); chunked_it != chunked_result.end(); ++chunked_it, ++it) {
+    ASSERT_NE(it, result.end());
+    EXPECT_EQ(chunked_it->obis_code(), it->obis_code());
+    EXPECT_EQ(chunked_it->data(), it->data());
+    ++num_objects;
+  }
+  EXPECT_EQ(it, result.end());
+  EXPECT_EQ(num_objects, std::clamp<size_t>(GetParam() / 64, 1, MAX_NUM_OBJECTS) + 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, ScalingTest,
+                         ::testing::Values(100, 256, 1024, 4096, 16 * 1024, 32 * 1024, 64 * 1024));
+
+}  // namespace
+}  // namespace esphome::efs
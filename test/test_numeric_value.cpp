@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "components/efs/numeric_value.h"
+#include "components/efs/object.h"
+
+namespace esphome::efs {
+namespace {
+
+NumericValue parse(const char *data) {
+  NumericValue value{0, 0, Unit::NONE};
+  EXPECT_TRUE(parse_numeric(data, strlen(data), value)) << data;
+  return value;
+}
+
+bool is_numeric(const char *data) {
+  NumericValue value{0, 0, Unit::NONE};
+  return parse_numeric(data, strlen(data), value);
+}
+
+TEST(NumericValueTest, ParsesDecimalValueWithUnit) {
+  const auto value = parse("123456.789*kWh");
+  EXPECT_EQ(value.mantissa, 123456789);
+  EXPECT_EQ(value.scale, -3);
+  EXPECT_EQ(value.unit, Unit::KWH);
+}
+
+TEST(NumericValueTest, ParsesIntegerWithoutUnit) {
+  const auto value = parse("00004");
+  EXPECT_EQ(value.mantissa, 4);
+  EXPECT_EQ(value.scale, 0);
+  EXPECT_EQ(value.unit, Unit::NONE);
+}
+
+TEST(NumericValueTest, ParsesSign) {
+  EXPECT_EQ(parse("-01.193*kW").mantissa, -1193);
+  EXPECT_EQ(parse("+01.193*kW").mantissa, 1193);
+}
+
+TEST(NumericValueTest, ParsesUnitsIgnoringCase) {
+  EXPECT_EQ(parse("1*kvarh").unit, Unit::KVARH);
+  EXPECT_EQ(parse("1*kVArh").unit, Unit::KVARH);
+  EXPECT_EQ(parse("1*m3").unit, Unit::M3);
+  EXPECT_EQ(parse("1*V").unit, Unit::V);
+  EXPECT_EQ(parse("1*A").unit, Unit::A);
+  EXPECT_EQ(parse("1*s").unit, Unit::S);
+  EXPECT_EQ(parse("1*furlong").unit, Unit::UNKNOWN);
+  EXPECT_EQ(parse("1*").unit, Unit::NONE);
+}
+
+TEST(NumericValueTest, RejectsNonNumericValues) {
+  EXPECT_FALSE(is_numeric(""));
+  EXPECT_FALSE(is_numeric("."));
+  EXPECT_FALSE(is_numeric("-"));
+  EXPECT_FALSE(is_numeric("*kWh"));
+  EXPECT_FALSE(is_numeric("101209113020W"));
+  EXPECT_FALSE(is_numeric("4B384547"));
+  EXPECT_FALSE(is_numeric("1.2.3"));
+  EXPECT_FALSE(is_numeric("0:96.7.19"));
+}
+
+TEST(NumericValueTest, RejectsValuesThatDoNotFit) {
+  EXPECT_TRUE(is_numeric("999999999999999999"));
+  EXPECT_FALSE(is_numeric("9999999999999999999"));
+  EXPECT_TRUE(is_numeric("0000000000000000000000000001"));
+}
+
+TEST(NumericValueTest, NormalizesToKiloUnits) {
+  const auto value = parse("1234*Wh").normalized();
+  EXPECT_EQ(value.mantissa, 1234);
+  EXPECT_EQ(value.scale, -3);
+  EXPECT_EQ(value.unit, Unit::KWH);
+  EXPECT_EQ(parse("5*W").normalized().unit, Unit::KW);
+  EXPECT_EQ(parse("5*kW").normalized().scale, 0);
+  EXPECT_EQ(parse("5*V").normalized().unit, Unit::V);
+}
+
+TEST(NumericValueTest, ConvertsToFloat) {
+  EXPECT_FLOAT_EQ(parse("01.193*kW").to_float(), 1.193f);
+  EXPECT_FLOAT_EQ(parse("230.1*V").to_float(), 230.1f);
+  EXPECT_FLOAT_EQ((NumericValue{5, 2, Unit::NONE}).to_float(), 500.0f);
+}
+
+TEST(NumericValueTest, ConvertsToFixedPoint) {
+  EXPECT_EQ(parse("123456.789*kWh").to_fixed_point(-3), 123456789);
+  EXPECT_EQ(parse("123456.789*kWh").to_fixed_point(-6), 123456789000);
+  EXPECT_EQ(parse("230*V").to_fixed_point(-3), 230000);
+  EXPECT_EQ(parse("0.0000*kW").to_fixed_point(-3), 0);
+  EXPECT_EQ((NumericValue{5, 2, Unit::NONE}).to_fixed_point(-3), 500000);
+}
+
+TEST(NumericValueTest, RoundsHalfAwayFromZeroWhenReducingDecimals) {
+  EXPECT_EQ(parse("1.2345").to_fixed_point(-3), 1235);
+  EXPECT_EQ(parse("1.2344").to_fixed_point(-3), 1234);
+  EXPECT_EQ(parse("-1.2345").to_fixed_point(-3), -1235);
+  EXPECT_EQ(parse("-1.2344").to_fixed_point(-3), -1234);
+  EXPECT_EQ(parse("0.5").to_fixed_point(0), 1);
+  EXPECT_EQ(parse("0.4999").to_fixed_point(0), 0);
+  EXPECT_EQ(parse("0.000000000000000001").to_fixed_point(0), 0);
+}
+
+TEST(NumericValueTest, FixedPointOverflowIsDetected) {
+  EXPECT_FALSE(parse("999999999999999999").to_fixed_point(-3).has_value());
+  EXPECT_EQ((NumericValue{INT64_MAX, -3, Unit::NONE}).to_fixed_point(-3), INT64_MAX);
+  EXPECT_FALSE((NumericValue{INT64_MAX / 10 + 1, -2, Unit::NONE}).to_fixed_point(-3).has_value());
+  EXPECT_FALSE((NumericValue{INT64_MIN / 10 - 1, -2, Unit::NONE}).to_fixed_point(-3).has_value());
+  EXPECT_FALSE((NumericValue{1, 19, Unit::NONE}).to_fixed_point(0).has_value());
+}
+
+TEST(NumericValueTest, NineDigitCountersAreExact) {
+  // A float only has 24 bits of precision, so strtof loses the last digits of large counters
+  size_t strtof_mismatches = 0;
+  for (int64_t counter = 100000000; counter < 1000000000; counter += 7654321) {
+    const std::string text = std::to_string(counter / 1000) + "." + std::to_string(1000 + counter % 1000).substr(1);
+    const auto value = parse(text.c_str());
+    EXPECT_EQ(value.to_fixed_point(-3), counter) << text;
+    // The published float is the float nearest to the exact value
+    EXPECT_EQ(value.to_float(3), static_cast<float>(static_cast<double>(counter) / 1000)) << text;
+    if (static_cast<int64_t>(static_cast<double>(std::strtof(text.c_str(), nullptr)) * 1000 + 0.5) != counter) {
+      ++strtof_mismatches;
+    }
+  }
+  EXPECT_GT(strtof_mismatches, 0);
+}
+
+TEST(NumericValueTest, RoundsToAccuracyDecimals) {
+  EXPECT_EQ(parse("1.23456*kW").to_float(3), 1.235f);
+  EXPECT_EQ(parse("1.23456*kW").to_float(0), 1.0f);
+  EXPECT_EQ(parse("1234.5*W").to_float(-1), 1230.0f);
+  EXPECT_FALSE(parse("1").to_float(19).has_value());
+}
+
+TEST(NumericValueTest, ObjectDecodesValueAtIndex) {
+  const char data[] = "101209110000W\0" "12785.123*m3";
+  const Object object(ObisCode(0, 1, 24, 2, 1), 2, std::string_view(data, sizeof(data)));
+  EXPECT_FALSE(object.numeric(0).has_value());
+  ASSERT_TRUE(object.numeric(1).has_value());
+  EXPECT_EQ(object.numeric(1)->mantissa, 12785123);
+  EXPECT_EQ(object.numeric(1)->unit, Unit::M3);
+  EXPECT_FALSE(object.numeric(2).has_value());
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "components/efs/obis_code.h"
+
+namespace esphome::efs {
+namespace {
+
+// The literal and the predefined codes are evaluated at compile time
+static_assert("1-0:1.8.0"_obis == ENERGY_IMPORTED);
+static_assert("0-1:24.2.1"_obis == ObisCode(0, 1, 24, 2, 1));
+static_assert("255-255:255.255.255"_obis == ObisCode(255, 255, 255, 255, 255));
+static_assert(ENERGY_IMPORTED < ENERGY_IMPORTED_TARIFF1);
+static_assert(ObisCode(0, 255, 255, 255, 255) < ObisCode(1, 0, 0, 0, 0));
+static_assert(VOLTAGE_L1.key() == 0x0100200700);
+static_assert(VOLTAGE_L1[2] == 32);
+
+// A literal is a valid code if it can be evaluated at compile time
+template<const char *Str, size_t Size, uint64_t Key = operator""_obis(Str, Size).key()>
+constexpr bool is_valid_literal(int) {
+  return true;
+}
+template<const char *Str, size_t Size> constexpr bool is_valid_literal(...) { return false; }
+
+constexpr char VALID[] = "1-0:1.8.0";
+constexpr char MISSING_PART[] = "1-0:1.8";
+constexpr char OUT_OF_RANGE[] = "1-0:1.8.256";
+static_assert(is_valid_literal<VALID, sizeof(VALID) - 1>(0));
+static_assert(!is_valid_literal<MISSING_PART, sizeof(MISSING_PART) - 1>(0));
+static_assert(!is_valid_literal<OUT_OF_RANGE, sizeof(OUT_OF_RANGE) - 1>(0));
+
+TEST(ObisCodeTest, ReturnsParts) {
+  const ObisCode obis_code(1, 2, 3, 4, 5);
+  for (size_t pos = 0; pos < 5; ++pos) {
+    EXPECT_EQ(obis_code[pos], pos + 1);
+  }
+}
+
+TEST(ObisCodeTest, ComparesLexicographically) {
+  const ObisCode codes[] = {ObisCode(0, 0, 0, 0, 0),    ObisCode(0, 0, 0, 0, 255),   ObisCode(0, 0, 0, 1, 0),
+                            ObisCode(0, 0, 1, 0, 0),    ObisCode(0, 1, 0, 0, 0),     ObisCode(1, 0, 0, 0, 0),
+                            ObisCode(1, 0, 255, 7, 0), ObisCode(255, 255, 255, 255, 255)};
+  for (size_t i = 0; i < std::size(codes); ++i) {
+    for (size_t j = 0; j < std::size(codes); ++j) {
+      EXPECT_EQ(codes[i] < codes[j], i < j);
+      EXPECT_EQ(codes[i] == codes[j], i == j);
+    }
+  }
+}
+
+TEST(ObisCodeTest, ConvertsToAndFromBytes) {
+  const uint8_t bytes[5] = {1, 0, 99, 98, 1};
+  const auto obis_code = ObisCode::from_bytes(bytes);
+  EXPECT_EQ(obis_code, "1-0:99.98.1"_obis);
+  uint8_t copy[5] = {0};
+  obis_code.to_bytes(copy);
+  EXPECT_EQ(std::memcmp(bytes, copy, sizeof(bytes)), 0);
+  EXPECT_EQ(ObisCode::from_key(obis_code.key()), obis_code);
+}
+
+TEST(ObisCodeTest, HashesByKey) {
+  const std::hash<ObisCode> hash;
+  EXPECT_EQ(hash(ENERGY_IMPORTED), hash("1-0:1.8.0"_obis));
+  EXPECT_NE(hash(ENERGY_IMPORTED), hash(ENERGY_EXPORTED));
+}
+
+TEST(ObisCodeTest, InvalidCodeParsedAtRuntimeIsZero) {
+  // These would fail to compile as literals
+  for (const char *str : {"1-0:1.8", "1-0:1.8.0.0", "1-0:1.8.256", "1-0:1:8.0", "1-0:1.8.0000", "1-0:.8.0", ""}) {
+    EXPECT_EQ(util::parse_obis_code(str, strlen(str)), ObisCode(0, 0, 0, 0, 0)) << str;
+  }
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <string>
 #include <string_view>
@@ -8,7 +9,10 @@
 
 #include "components/efs/header.h"
 #include "components/efs/parser.h"
+#include "matchers.h"
 
+using ::testing::ElementsAre;
+using esphome::efs::testing::ObjectLike;
 using std::literals::operator""sv;
 
 namespace esphome::efs {
@@ -17,6 +21,7 @@ namespace {
 class StubCrcCalculator {
  public:
   void update(const char &) {}
+  void update(const char *, size_t) {}
   void reset() {}
   uint16_t crc() { return 0; }
 };
@@ -236,5 +241,202 @@ TEST_F(ParserTest, ParsedDataLayout) {
   EXPECT_STREQ(value5_1, "3.1415");
 }
 
+TEST_F(ParserTest, FeedInChunksProducesSameOutputAsInPlaceParsing) {
+  const auto input = "/ISK5\r\n"
+                     "1-0:1.8.0*255(123456.78)\r\n"
+                     "1-0:2.8.0*255(987654.32)(123)\r\n"
+                     "1-0:3.8.0()(ABC)()\r\n"
+                     "1-0:4.8.0\r\n"
+                     "1-0:5.8.0(3.1415)\r\n"
+                     "!0000\r\n"sv;
+  const auto serialize = [](const Result &result) {
+    std::string output;
+    for (const auto &object : result) {
+      output.append(reinterpret_cast<const char *>(&object.obis_code()), sizeof(ObisCode));
+      output.push_back(static_cast<char>(object.num_values()));
+      output.append(object.data());
+    }
+    return output;
+  };
+  load_buffer_(input);
+  auto expected = parser_.parse_telegram(buffer_.data(), buffer_.size());
+  ASSERT_EQ(expected.status, Status::OK);
+  const auto expected_output = serialize(expected);
+
+  for (size_t chunk_size = 1; chunk_size <= input.size(); ++chunk_size) {
+    alignas(2) char output[128]{};
+    ASSERT_EQ(parser_.begin(output, sizeof(output)), Status::OK);
+    for (size_t pos = 0; pos < input.size(); pos += chunk_size) {
+      parser_.feed(&input[pos], std::min(chunk_size, input.size() - pos));
+    }
+    auto result = parser_.finish();
+    ASSERT_EQ(result.status, Status::OK) << "chunk size " << chunk_size;
+    EXPECT_EQ(serialize(result), expected_output) << "chunk size " << chunk_size;
+  }
+}
+
+TEST_F(ParserTest, FeedReturnsStatusAsSoonAsAnErrorOccurs) {
+  alignas(2) char output[64]{};
+  parser_.begin(output, sizeof(output));
+  EXPECT_EQ(parser_.feed("/ISK5\r\n", 7), Status::OK);
+  EXPECT_EQ(parser_.feed("1-0:999", 7), Status::INVALID_OBIS_CODE);
+  EXPECT_EQ(parser_.finish().status, Status::INVALID_OBIS_CODE);
+}
+
+TEST_F(ParserTest, FeedReturnsWriteOverflowWhenOutputBufferIsFull) {
+  alignas(2) char output[16]{};
+  parser_.begin(output, sizeof(output));
+  EXPECT_EQ(parser_.feed("/ISK5\r\n1-0:1.8.0(123456.78)\r\n", 30), Status::WRITE_OVERFLOW);
+}
+
+TEST_F(ParserTest, FinishReturnsParsingFailedForIncompleteObject) {
+  alignas(2) char output[64]{};
+  parser_.begin(output, sizeof(output));
+  parser_.feed("/ISK5\r\n1-0:1.8.0(12", 19);
+  EXPECT_EQ(parser_.finish().status, Status::PARSING_FAILED);
+}
+
+TEST_F(ParserTest, ValueOnNewLineBelongsToPreviousObject) {
+  load_buffer_("/ISK5\r\n"
+               "0-1:24.3.0(090212160000)(00)(60)(1)(0-1:24.2.1)(m3)\r\n"
+               "(00001.001)\r\n"
+               "0-1:24.4.0(1)\r\n"
+               "!0000\r\n"sv);
+  auto result = parser_.parse_telegram(buffer_.data(), buffer_.size());
+  ASSERT_EQ(result.status, Status::OK);
+
+  auto it = result.begin();
+  ++it;
+  ASSERT_NE(it, result.end());
+  EXPECT_EQ(it->obis_code(), ObisCode(0, 1, 24, 3, 0));
+  EXPECT_EQ(it->num_values(), 7);
+  ++it;
+  ASSERT_NE(it, result.end());
+  EXPECT_EQ(it->obis_code(), ObisCode(0, 1, 24, 4, 0));
+  EXPECT_EQ(it->num_values(), 1);
+}
+
+TEST_F(ParserTest, ChecksumMarkerInsideValueIsIncludedInChecksum) {
+  std::string input = "/ISK5\r\n0-0:96.13.0(Hi!)\r\n1-0:1.8.0(1)\r\n!A767\r\n";
+  Parser parser;
+  for (size_t chunk_size : {input.size(), size_t{1}, size_t{5}}) {
+    alignas(2) char output[64]{};
+    parser.begin(output, sizeof(output));
+    for (size_t pos = 0; pos < input.size(); pos += chunk_size) {
+      parser.feed(&input[pos], std::min(chunk_size, input.size() - pos));
+    }
+    EXPECT_EQ(parser.finish().status, Status::OK) << "chunk size " << chunk_size;
+  }
+  load_buffer_(input);
+  EXPECT_EQ(parser.parse_telegram(buffer_.data(), buffer_.size()).status, Status::OK);
+}
+
+TEST_F(ParserTest, IndexIsSortedByObisCode) {
+  const auto input = "/ISK5\r\n"
+                     "1-0:2.8.0(2)\r\n"
+                     "1-0:1.8.0(1)\r\n"
+                     "0-1:24.2.1(101209110000W)(3*m3)\r\n"
+                     "1-0:1.8.0(4)\r\n"
+                     "!0000\r\n"sv;
+  alignas(2) char output[256]{};
+  parser_.set_index(true);
+  parser_.begin(output, sizeof(output));
+  parser_.feed(input.data(), input.size());
+  const auto result = parser_.finish();
+  ASSERT_EQ(result.status, Status::OK);
+
+  // The index follows the last object
+  const char *pos = output + strlen(output) + 2;
+  for (int i = 0; i < 4; ++i) {
+    pos += reinterpret_cast<const Header *>(pos)->object_size;
+  }
+  const auto *index = reinterpret_cast<const IndexEntry *>(pos);
+  const ObisCode expected[] = {ObisCode(0, 1, 24, 2, 1), ObisCode(1, 0, 1, 8, 0), ObisCode(1, 0, 1, 8, 0),
+                               ObisCode(1, 0, 2, 8, 0)};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(ObisCode::from_bytes(index[i].obis_code), expected[i]);
+  }
+
+  // Objects with the same OBIS code keep their order
+  EXPECT_THAT(*result.find(ObisCode(1, 0, 1, 8, 0)),
+              ObjectLike(ObisCode(1, 0, 1, 8, 0), std::vector<const char *>{"1"}));
+  EXPECT_THAT(*result.find(ObisCode(0, 1, 24, 2, 1)),
+              ObjectLike(ObisCode(0, 1, 24, 2, 1), std::vector<const char *>{"101209110000W", "3*m3"}));
+  EXPECT_FALSE(result.find(ObisCode(1, 0, 3, 8, 0)).has_value());
+}
+
+TEST_F(ParserTest, IndexIsOmittedWhenItDoesNotFit) {
+  const auto input = "/ISK5\r\n1-0:2.8.0(2)\r\n1-0:1.8.0(1)\r\n!0000\r\n"sv;
+  // Room for the output but not for the index
+  alignas(2) char output[32]{};
+  parser_.set_index(true);
+  parser_.begin(output, sizeof(output));
+  parser_.feed(input.data(), input.size());
+  const auto result = parser_.finish();
+  ASSERT_EQ(result.status, Status::OK);
+
+  EXPECT_THAT(*result.find(ObisCode(1, 0, 1, 8, 0)),
+              ObjectLike(ObisCode(1, 0, 1, 8, 0), std::vector<const char *>{"1"}));
+  EXPECT_THAT(*result.find(ObisCode(1, 0, 2, 8, 0)),
+              ObjectLike(ObisCode(1, 0, 2, 8, 0), std::vector<const char *>{"2"}));
+  EXPECT_FALSE(result.find(ObisCode(0, 0, 0, 0, 0)).has_value());
+}
+
+TEST_F(ParserTest, FilterSkipsObjectsNotInFilter) {
+  load_buffer_("/ISK5\r\n"
+               "1-0:1.8.0*255(123456.78)\r\n"
+               "1-0:2.8.0*255(987654.32)(123)\r\n"
+               "1-0:3.8.0()(ABC)()\r\n"
+               "(DEF)\r\n"
+               "1-0:4.8.0\r\n"
+               "1-0:5.8.0(3.1415)\r\n"
+               "!0000\r\n"sv);
+  const std::array<ObisCode, 2> filter{ObisCode(1, 0, 2, 8, 0), ObisCode(1, 0, 5, 8, 0)};
+  parser_.set_filter(filter.data(), filter.size());
+  auto result = parser_.parse_telegram(buffer_.data(), buffer_.size());
+  ASSERT_EQ(result.status, Status::OK);
+
+  EXPECT_THAT(result,
+              ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"ISK5"}),
+                          ObjectLike(ObisCode(1, 0, 2, 8, 0), std::vector<const char *>{"987654.32", "123"}),
+                          ObjectLike(ObisCode(1, 0, 5, 8, 0), std::vector<const char *>{"3.1415"})));
+
+  // Skipped objects are not written to the output
+  const uint8_t num_objects = buffer_[strlen(buffer_.data()) + 1];
+  EXPECT_EQ(num_objects, 2);
+}
+
+#ifndef NDEBUG
+TEST_F(ParserTest, UnsortedFilterIsRejected) {
+  // The filter is searched with a binary search, which would miss objects in an unsorted filter
+  const std::array<ObisCode, 2> filter{ObisCode(1, 0, 5, 8, 0), ObisCode(1, 0, 2, 8, 0)};
+  EXPECT_DEATH(parser_.set_filter(filter.data(), filter.size()), "is_sorted");
+}
+#endif
+
+TEST_F(ParserTest, EmptyFilterSkipsAllObjects) {
+  load_buffer_("/ISK5\r\n1-0:1.8.0(1)\r\n1-0:2.8.0(2)\r\n!0000\r\n"sv);
+  const ObisCode filter[1] = {ObisCode(0, 0, 0, 0, 0)};
+  parser_.set_filter(filter, 0);
+  auto result = parser_.parse_telegram(buffer_.data(), buffer_.size());
+  ASSERT_EQ(result.status, Status::OK);
+  EXPECT_THAT(result, ElementsAre(ObjectLike(ObisCode(0, 0, 0, 0, 0), std::vector<const char *>{"ISK5"})));
+}
+
+TEST_F(ParserTest, FilterCanBeDisabled) {
+  load_buffer_("/ISK5\r\n1-0:1.8.0(1)\r\n1-0:2.8.0(2)\r\n!0000\r\n"sv);
+  const ObisCode filter[1] = {ObisCode(1, 0, 2, 8, 0)};
+  parser_.set_filter(filter, 1);
+  parser_.set_filter(nullptr, 0);
+  auto result = parser_.parse_telegram(buffer_.data(), buffer_.size());
+  ASSERT_EQ(result.status, Status::OK);
+  size_t num_objects = 0;
+  for (const auto &object : result) {
+    EXPECT_NE(object.num_values(), 0);
+    ++num_objects;
+  }
+  EXPECT_EQ(num_objects, 3);
+}
+
 }  // namespace
 }  // namespace esphome::efs
@@ -0,0 +1,142 @@
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "components/efs/parser.h"
+#include "components/efs/profile.h"
+#include "telegram_corpus.h"
+
+namespace esphome::efs {
+namespace {
+
+Timestamp timestamp(const char *data) {
+  Timestamp timestamp{0, false};
+  EXPECT_TRUE(parse_timestamp(data, strlen(data), timestamp)) << data;
+  return timestamp;
+}
+
+class ProfileViewTest : public ::testing::TestWithParam<Encoding> {
+ protected:
+  // Parse telegram and return the object with obis_code, telegrams without a checksum are not checked
+  std::optional<Object> parse(const std::string &telegram, const ObisCode &obis_code) {
+    buffer_ = telegram;
+    parser_.set_encoding(GetParam());
+    result_.emplace(parser_.parse_telegram(buffer_.data(), buffer_.size()));
+    EXPECT_EQ(result_->status, Status::OK);
+    return result_->find(obis_code);
+  }
+
+  Parser parser_;
+  std::string buffer_;
+  std::optional<Result> result_;
+};
+
+TEST_P(ProfileViewTest, EventLog) {
+  const auto object = parse(testing::load_telegram("dsmr5_kaifa.txt"), ObisCode(1, 0, 99, 97, 0));
+  ASSERT_TRUE(object.has_value());
+  const auto view = ProfileView::from_object(*object);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(view->layout(), ProfileLayout::EVENT_LOG);
+  EXPECT_EQ(view->size(), 3U);
+  EXPECT_EQ(view->column(), ObisCode(0, 0, 96, 7, 19));
+
+  std::vector<Timestamp> timestamps;
+  std::vector<int64_t> durations;
+  for (const auto &record : *view) {
+    timestamps.push_back(*record.timestamp());
+    const auto value = record.value();
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(value->unit, Unit::S);
+    durations.push_back(*value->to_fixed_point(0));
+  }
+  EXPECT_EQ(timestamps, (std::vector<Timestamp>{timestamp("180307160410W"), timestamp("181129093018W"),
+                                                timestamp("190204150506W")}));
+  EXPECT_EQ(durations, (std::vector<int64_t>{225, 3619, 289}));
+}
+
+TEST_P(ProfileViewTest, IntervalProfile) {
+  const auto object = parse(testing::load_telegram("dsmr22_iskra.txt"), ObisCode(0, 1, 24, 3, 0));
+  ASSERT_TRUE(object.has_value());
+  const auto view = ProfileView::from_object(*object);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(view->layout(), ProfileLayout::INTERVAL);
+  EXPECT_EQ(view->size(), 1U);
+  EXPECT_EQ(view->column(), ObisCode(0, 1, 24, 2, 1));
+  EXPECT_EQ(view->unit(), Unit::M3);
+
+  auto it = view->begin();
+  ASSERT_NE(it, view->end());
+  EXPECT_EQ(it->timestamp(), timestamp("120517020000"));
+  EXPECT_EQ(it->raw_value(), "00124.477");
+  const auto value = it->value();
+  ASSERT_TRUE(value.has_value());
+  EXPECT_EQ(value->unit, Unit::M3);
+  EXPECT_EQ(value->to_fixed_point(-3), 124477);
+  EXPECT_EQ(++it, view->end());
+}
+
+TEST_P(ProfileViewTest, IntervalRecordsArePeriodApart) {
+  const auto object = parse("/XYZ5\r\n\r\n0-1:24.3.0(090212160000)(00)(15)(3)(0-1:24.2.1)(m3)\r\n"
+                            "(00001.001)\r\n(00001.002)\r\n(00001.003)\r\n",
+                            ObisCode(0, 1, 24, 3, 0));
+  ASSERT_TRUE(object.has_value());
+  const auto view = ProfileView::from_object(*object);
+  ASSERT_TRUE(view.has_value());
+  std::vector<int64_t> times;
+  for (const auto &record : *view) {
+    times.push_back(record.timestamp()->local_time - timestamp("090212160000").local_time);
+  }
+  EXPECT_EQ(times, (std::vector<int64_t>{0, 900, 1800}));
+}
+
+TEST_P(ProfileViewTest, MissingRecordsEndIteration) {
+  // Three records are announced but only one and a half are present, the short column form has no A group
+  const auto object = parse("/XYZ5\r\n\r\n1-0:99.97.0(3)(0:96.7.19)(101208152415W)(0000000240*s)(101208151004W)\r\n",
+                            ObisCode(1, 0, 99, 97, 0));
+  ASSERT_TRUE(object.has_value());
+  const auto view = ProfileView::from_object(*object);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(view->size(), 3U);
+  EXPECT_EQ(view->column(), ObisCode(0, 0, 96, 7, 19));
+  size_t num_records = 0;
+  for (const auto &record : *view) {
+    EXPECT_EQ(record.raw_value(), "0000000240*s");
+    ++num_records;
+  }
+  EXPECT_EQ(num_records, 1U);
+}
+
+TEST_P(ProfileViewTest, EmptyEventLog) {
+  const auto object = parse("/XYZ5\r\n\r\n1-0:99.97.0(0)(0-0:96.7.19)\r\n", ObisCode(1, 0, 99, 97, 0));
+  ASSERT_TRUE(object.has_value());
+  const auto view = ProfileView::from_object(*object);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(view->begin(), view->end());
+}
+
+TEST_P(ProfileViewTest, OtherObjectsAreNotProfiles) {
+  const std::string telegram = "/XYZ5\r\n\r\n0-1:24.2.1(101209110000W)(12785.123*m3)\r\n1-0:1.8.1(000123.456*kWh)\r\n"
+                               "0-0:96.7.21(00004)\r\n";
+  EXPECT_FALSE(ProfileView::from_object(*parse(telegram, ObisCode(0, 1, 24, 2, 1))).has_value());
+  EXPECT_FALSE(ProfileView::from_object(*parse(telegram, ObisCode(1, 0, 1, 8, 1))).has_value());
+  EXPECT_FALSE(ProfileView::from_object(*parse(telegram, ObisCode(0, 0, 96, 7, 21))).has_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(Encodings, ProfileViewTest, ::testing::Values(Encoding::PADDED, Encoding::COMPACT));
+
+TEST(ParseColumnObisCodeTest, FullAndShortForms) {
+  ObisCode obis_code(0, 0, 0, 0, 0);
+  EXPECT_TRUE(util::parse_column_obis_code("0-1:24.2.1", obis_code));
+  EXPECT_EQ(obis_code, ObisCode(0, 1, 24, 2, 1));
+  EXPECT_TRUE(util::parse_column_obis_code("1:96.7.19", obis_code));
+  EXPECT_EQ(obis_code, ObisCode(0, 1, 96, 7, 19));
+  EXPECT_FALSE(util::parse_column_obis_code("96.7.19", obis_code));
+  EXPECT_FALSE(util::parse_column_obis_code("0-0:96.7.256", obis_code));
+  EXPECT_FALSE(util::parse_column_obis_code("", obis_code));
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "components/efs/publish_policy.h"
+
+namespace esphome::efs {
+namespace {
+
+TEST(PublishPolicyTest, DefaultPublishesEveryState) {
+  PublishFilter filter;
+  EXPECT_TRUE(filter.should_publish(1.0f, 0));
+  EXPECT_TRUE(filter.should_publish(1.0f, 1000));
+  EXPECT_TRUE(filter.should_publish(2.0f, 2000));
+}
+
+TEST(PublishPolicyTest, OnChangeSkipsUnchangedStates) {
+  PublishFilter filter(PublishPolicy{true, 0.0f, 0.0f, 0});
+  EXPECT_TRUE(filter.should_publish(1.0f, 0));
+  EXPECT_FALSE(filter.should_publish(1.0f, 1000));
+  EXPECT_TRUE(filter.should_publish(1.001f, 2000));
+  EXPECT_FALSE(filter.should_publish(1.001f, 3000));
+}
+
+TEST(PublishPolicyTest, DeltaComparesWithLastPublishedState) {
+  PublishFilter filter(PublishPolicy{false, 0.1f, 0.0f, 0});
+  EXPECT_TRUE(filter.should_publish(1.0f, 0));
+  EXPECT_FALSE(filter.should_publish(1.05f, 1000));
+  // A slow drift is published once it adds up to the delta
+  EXPECT_FALSE(filter.should_publish(1.09f, 2000));
+  EXPECT_TRUE(filter.should_publish(1.125f, 3000));
+  EXPECT_FALSE(filter.should_publish(1.05f, 4000));
+  EXPECT_TRUE(filter.should_publish(1.0f, 5000));
+}
+
+TEST(PublishPolicyTest, RelativeDeltaScalesWithLastPublishedState) {
+  PublishFilter filter(PublishPolicy{false, 0.0f, 0.01f, 0});
+  EXPECT_TRUE(filter.should_publish(1000.0f, 0));
+  EXPECT_FALSE(filter.should_publish(1009.0f, 1000));
+  EXPECT_TRUE(filter.should_publish(1011.0f, 2000));
+  EXPECT_FALSE(filter.should_publish(1001.0f, 3000));
+  EXPECT_TRUE(filter.should_publish(1000.0f, 4000));
+}
+
+TEST(PublishPolicyTest, HeartbeatForcesPublishing) {
+  PublishFilter filter(PublishPolicy{true, 0.0f, 0.0f, 60000});
+  EXPECT_TRUE(filter.should_publish(1.0f, 0));
+  EXPECT_FALSE(filter.should_publish(1.0f, 59999));
+  EXPECT_TRUE(filter.should_publish(1.0f, 60000));
+  EXPECT_FALSE(filter.should_publish(1.0f, 61000));
+  // The heartbeat restarts when a changed state is published
+  EXPECT_TRUE(filter.should_publish(2.0f, 100000));
+  EXPECT_FALSE(filter.should_publish(2.0f, 159999));
+}
+
+TEST(PublishPolicyTest, HeartbeatHandlesMillisOverflow) {
+  PublishFilter filter(PublishPolicy{true, 0.0f, 0.0f, 1000});
+  EXPECT_TRUE(filter.should_publish(1.0f, UINT32_MAX - 499));
+  EXPECT_FALSE(filter.should_publish(1.0f, 499));
+  EXPECT_TRUE(filter.should_publish(1.0f, 500));
+}
+
+TEST(PublishPolicyTest, NanIsAlwaysPublished) {
+  PublishFilter filter(PublishPolicy{true, 1.0f, 0.0f, 0});
+  EXPECT_TRUE(filter.should_publish(NAN, 0));
+  EXPECT_TRUE(filter.should_publish(NAN, 1000));
+  EXPECT_TRUE(filter.should_publish(1.0f, 2000));
+}
+
+}  // namespace
+}  // namespace esphome::efs
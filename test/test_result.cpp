@@ -35,6 +35,43 @@ TEST_F(ResultTest, NormalOperation) {
                                 Property(&Object::num_values, 2), ElementsAre(ValueEq("qwerty"), ValueEq("uiop")))));
 }
 
+TEST_F(ResultTest, FindWithoutIndex) {
+  const char buffer[] = "Test\0\x02"
+                        "\x01\x02\x03\x04\x05\x01\x14\x00Test again\0\0"
+                        "\x07\x08\x09\x0A\x0B\x02\x14\x00qwerty\0uiop\0";
+  const auto result = Result(Status::OK, buffer, sizeof(buffer));
+
+  const auto object = result.find(ObisCode(7, 8, 9, 10, 11));
+  ASSERT_TRUE(object.has_value());
+  EXPECT_THAT(*object, AllOf(Property(&Object::obis_code, ObisCode(7, 8, 9, 10, 11)), Property(&Object::num_values, 2),
+                             ElementsAre(ValueEq("qwerty"), ValueEq("uiop"))));
+  EXPECT_FALSE(result.find(ObisCode(0, 0, 0, 0, 0)).has_value());
+  EXPECT_FALSE(result.find(ObisCode(1, 2, 3, 4, 6)).has_value());
+}
+
+TEST_F(ResultTest, FingerprintChangesWithValueBytes) {
+  const char first[] = "Test\0\x02"
+                       "\x01\x02\x03\x04\x05\x01\x0C\x00" "1.5\0"
+                       "\x07\x08\x09\x0A\x0B\x02\x0C\x00" "1\0" "5\0";
+  const char second[] = "Test\0\x02"
+                        "\x01\x02\x03\x04\x05\x01\x0C\x00" "1.5\0"
+                        "\x07\x08\x09\x0A\x0B\x02\x0C\x00" "1\0" "6\0";
+  std::vector<uint32_t> first_fingerprints;
+  for (const auto &object : Result(Status::OK, first, sizeof(first))) {
+    first_fingerprints.push_back(object.fingerprint());
+  }
+  std::vector<uint32_t> second_fingerprints;
+  for (const auto &object : Result(Status::OK, second, sizeof(second))) {
+    second_fingerprints.push_back(object.fingerprint());
+  }
+  ASSERT_EQ(first_fingerprints.size(), 3);
+  ASSERT_EQ(second_fingerprints.size(), 3);
+  EXPECT_EQ(first_fingerprints[1], second_fingerprints[1]);
+  EXPECT_NE(first_fingerprints[2], second_fingerprints[2]);
+  // The value boundaries are part of the fingerprint
+  EXPECT_NE(first_fingerprints[1], first_fingerprints[2]);
+}
+
 TEST_F(ResultTest, EmptyBuffer) {
   const char *buffer = "";
   size_t buffer_size = 0;
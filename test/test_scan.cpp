@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <string>
+
+#include "components/efs/scan.h"
+
+namespace esphome::efs::util {
+namespace {
+
+TEST(CharClassTest, MatchesCctype) {
+  for (int i = 0; i < 256; ++i) {
+    const char ch = static_cast<char>(i);
+    EXPECT_EQ(is_space(ch), i < 128 && std::isspace(i) != 0) << i;
+    EXPECT_EQ(is_digit(ch), i < 128 && std::isdigit(i) != 0) << i;
+    EXPECT_EQ(is_hex_digit(ch), i < 128 && std::isxdigit(i) != 0) << i;
+  }
+}
+
+TEST(FindFirstOfTest, EmptyRange) {
+  const char *data = "";
+  EXPECT_EQ((find_first_of<')'>(data, data)), data);
+}
+
+TEST(FindFirstOfTest, NotFoundReturnsEnd) {
+  const std::string data(100, 'x');
+  EXPECT_EQ((find_first_of<'(', ')', '\r', '!'>(data.data(), data.data() + data.size())), data.data() + data.size());
+}
+
+TEST(FindFirstOfTest, FindsDelimiterAtEveryPositionAndAlignment) {
+  // Exercise the vectorized, word and byte wise paths and their boundaries
+  std::string buffer(96, 'x');
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t pos = offset; pos < buffer.size(); ++pos) {
+      for (const char delimiter : {'(', ')', '\r', '!', '\0'}) {
+        std::string data = buffer;
+        data[pos] = delimiter;
+        const char *begin = data.data() + offset;
+        const char *end = data.data() + data.size();
+        EXPECT_EQ((find_first_of<'(', ')', '\r', '!', '\0'>(begin, end)), data.data() + pos)
+            << "offset " << offset << " pos " << pos;
+      }
+    }
+  }
+}
+
+TEST(FindFirstOfTest, ReturnsFirstOfSeveralDelimiters) {
+  const std::string data = "0123456789ABCDEF0123456789ABCDEF(0123)\r\n!";
+  const char *begin = data.data();
+  const char *end = data.data() + data.size();
+  EXPECT_EQ((find_first_of<')', '\r'>(begin, end)), begin + 37);
+  EXPECT_EQ((find_first_of<'!', '('>(begin, end)), begin + 32);
+  EXPECT_EQ((find_first_of<'!'>(begin, end)), begin + 40);
+}
+
+TEST(FindFirstOfTest, IgnoresBytesWithHighBitSet) {
+  // Bytes such as 0xA9 (')' | 0x80) and 0x00 followed by borrows must not match
+  std::string data(64, static_cast<char>(0xA9));
+  data[40] = ')';
+  EXPECT_EQ((find_first_of<')'>(data.data(), data.data() + data.size())), data.data() + 40);
+}
+
+}  // namespace
+}  // namespace esphome::efs::util
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "components/efs/object.h"
+#include "components/efs/sensor_table.h"
+
+namespace esphome::efs {
+namespace {
+
+struct FakeSensor {
+  void publish_state(float state) { states.push_back(state); }
+  int id;
+  std::vector<float> states{};
+};
+
+std::vector<int> find_ids(SensorTable<FakeSensor> &table, const ObisCode &obis_code) {
+  std::vector<int> ids;
+  const auto entries = table.find(obis_code);
+  for (auto entry = entries.first; entry != entries.second; ++entry) {
+    ids.push_back(entry->sensor->id);
+  }
+  return ids;
+}
+
+TEST(SensorTableTest, FindsSensorsInUnsortedInsertionOrder) {
+  FakeSensor sensors[] = {{0}, {1}, {2}};
+  SensorTable<FakeSensor> table;
+  table.reserve(3);
+  table.add(VOLTAGE_L1, &sensors[0], 1);
+  table.add(ENERGY_IMPORTED, &sensors[1], 3);
+  table.add(ObisCode(0, 1, 24, 2, 1), &sensors[2], 3);
+
+  EXPECT_EQ(find_ids(table, VOLTAGE_L1), std::vector<int>({0}));
+  EXPECT_EQ(find_ids(table, ENERGY_IMPORTED), std::vector<int>({1}));
+  EXPECT_EQ(find_ids(table, ObisCode(0, 1, 24, 2, 1)), std::vector<int>({2}));
+  EXPECT_TRUE(find_ids(table, CURRENT_L1).empty());
+  EXPECT_TRUE(find_ids(table, ObisCode(255, 255, 255, 255, 255)).empty());
+}
+
+TEST(SensorTableTest, FansOutToAllSensorsWithTheSameObisCode) {
+  FakeSensor sensors[] = {{0}, {1}, {2}, {3}};
+  SensorTable<FakeSensor> table;
+  table.add(POWER_IMPORTED, &sensors[0], 3);
+  table.add(ENERGY_IMPORTED, &sensors[1], 3);
+  table.add(POWER_IMPORTED, &sensors[2], 0);
+  table.add(POWER_IMPORTED, &sensors[3], -1);
+
+  EXPECT_EQ(table.size(), 4);
+  EXPECT_EQ(find_ids(table, POWER_IMPORTED), std::vector<int>({0, 2, 3}));
+  EXPECT_EQ(find_ids(table, ENERGY_IMPORTED), std::vector<int>({1}));
+}
+
+TEST(SensorTableTest, ListsDistinctObisCodesInOrder) {
+  FakeSensor sensor{0};
+  SensorTable<FakeSensor> table;
+  table.add(VOLTAGE_L1, &sensor, 1);
+  table.add(ENERGY_IMPORTED, &sensor, 3);
+  table.add(VOLTAGE_L1, &sensor, 0);
+
+  const auto obis_codes = table.obis_codes();
+  ASSERT_EQ(obis_codes.size(), 2);
+  EXPECT_EQ(obis_codes[0], ENERGY_IMPORTED);
+  EXPECT_EQ(obis_codes[1], VOLTAGE_L1);
+}
+
+// Values are NUL terminated in the parsed telegram
+Object make_object(const ObisCode &obis_code, uint8_t num_values, const char *data, size_t size) {
+  return Object(obis_code, num_values, std::string_view(data, size));
+}
+
+TEST(SensorTableTest, PublishesRoundedValuesToAllSensors) {
+  FakeSensor sensors[] = {{0}, {1}};
+  SensorTable<FakeSensor> table;
+  table.add(POWER_IMPORTED, &sensors[0], 1);
+  table.add(POWER_IMPORTED, &sensors[1], NO_ROUNDING);
+
+  const char data[] = "1.234*kW";
+  EXPECT_EQ(table.publish(make_object(POWER_IMPORTED, 1, data, sizeof(data)), 0), PublishStatus::DECODED);
+  EXPECT_EQ(sensors[0].states, std::vector<float>({1.2f}));
+  EXPECT_EQ(sensors[1].states, std::vector<float>({1.234f}));
+  EXPECT_EQ(table.publish(make_object(ENERGY_IMPORTED, 1, data, sizeof(data)), 0), PublishStatus::NO_SENSOR);
+  EXPECT_EQ(table.publish(make_object(POWER_IMPORTED, 0, "", 0), 0), PublishStatus::NO_VALUE);
+}
+
+TEST(SensorTableTest, ReusesStateOfUnchangedValue) {
+  FakeSensor sensor{0};
+  SensorTable<FakeSensor> table;
+  table.add(POWER_IMPORTED, &sensor, 3);
+
+  const char data[] = "1.234*kW";
+  const char changed[] = "1.235*kW";
+  EXPECT_EQ(table.publish(make_object(POWER_IMPORTED, 1, data, sizeof(data)), 0), PublishStatus::DECODED);
+  EXPECT_EQ(table.publish(make_object(POWER_IMPORTED, 1, data, sizeof(data)), 1000), PublishStatus::UNCHANGED);
+  EXPECT_EQ(table.publish(make_object(POWER_IMPORTED, 1, changed, sizeof(changed)), 2000), PublishStatus::DECODED);
+  EXPECT_EQ(sensor.states, std::vector<float>({1.234f, 1.234f, 1.235f}));
+}
+
+TEST(SensorTableTest, PublishesSubmeterReadingsOnlyWhenUpdated) {
+  FakeSensor sensor{0};
+  SensorTable<FakeSensor> table;
+  const ObisCode gas(0, 1, 24, 2, 1);
+  table.add(gas, &sensor, 3);
+
+  const char reading[] = "101209110000W\0" "12785.123*m3";
+  const char updated[] = "101209120000W\0" "12785.123*m3";
+  EXPECT_EQ(table.publish(make_object(gas, 2, reading, sizeof(reading)), 0), PublishStatus::DECODED);
+  EXPECT_EQ(table.publish(make_object(gas, 2, reading, sizeof(reading)), 1000), PublishStatus::UNCHANGED);
+  EXPECT_EQ(table.publish(make_object(gas, 2, updated, sizeof(updated)), 2000), PublishStatus::DECODED);
+  EXPECT_EQ(sensor.states, std::vector<float>({12785.123f, 12785.123f}));
+}
+
+TEST(SensorTableTest, ReusesStateOfRepeatedSubmeterReading) {
+  FakeSensor sensor{0};
+  SensorTable<FakeSensor> table;
+  const ObisCode gas(0, 1, 24, 2, 1);
+  table.add(gas, &sensor, 3);
+
+  // A changed value with the same timestamp is not published, nor decoded again when it is repeated
+  const char reading[] = "101209110000W\0" "12785.123*m3";
+  const char corrected[] = "101209110000W\0" "12785.124*m3";
+  EXPECT_EQ(table.publish(make_object(gas, 2, reading, sizeof(reading)), 0), PublishStatus::DECODED);
+  EXPECT_EQ(table.publish(make_object(gas, 2, corrected, sizeof(corrected)), 1000), PublishStatus::DECODED);
+  EXPECT_EQ(table.publish(make_object(gas, 2, corrected, sizeof(corrected)), 2000), PublishStatus::UNCHANGED);
+  EXPECT_EQ(sensor.states, std::vector<float>({12785.123f}));
+}
+
+TEST(SensorTableTest, ReportsInvalidNumbers) {
+  FakeSensor sensor{0};
+  SensorTable<FakeSensor> table;
+  table.add(POWER_IMPORTED, &sensor, 3);
+
+  const char data[] = "not a number";
+  EXPECT_EQ(table.publish(make_object(POWER_IMPORTED, 1, data, sizeof(data)), 0), PublishStatus::NOT_A_NUMBER);
+  EXPECT_TRUE(sensor.states.empty());
+}
+
+}  // namespace
+}  // namespace esphome::efs
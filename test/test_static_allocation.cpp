@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "components/efs/efs.h"
+#include "telegram_corpus.h"
+
+namespace {
+// Allocations counted while counting_allocations is set
+bool counting_allocations = false;
+size_t num_allocations = 0;
+}  // namespace
+
+// GCC warns about free() in the replacement operator delete, which does match malloc() in operator new
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void *operator new(size_t size) {
+  if (counting_allocations) {
+    ++num_allocations;
+  }
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t /*size*/) noexcept { std::free(ptr); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace esphome::efs {
+namespace {
+
+struct RecordingSensor {
+  void publish_state(float state) { this->state = state; }
+  float state{0};
+};
+
+using Entries = StaticVector<SensorEntry<RecordingSensor>, MAX_SENSORS>;
+
+// Telegrams are sent with a pause in between, the main loop runs every millisecond
+void run_loop(Efs &efs, int num_loops) {
+  for (int i = 0; i < num_loops; ++i) {
+    esphome::testing::now_us += 1000;
+    efs.loop();
+  }
+}
+
+TEST(StaticAllocationTest, ReceivingAndPublishingDoesNotAllocate) {
+  const std::string telegram = testing::load_telegram("se_aidon.txt");
+  ASSERT_FALSE(telegram.empty());
+  uart::UARTComponent uart;
+  uart.reserve(telegram.size());
+  Efs efs(&uart);
+  efs.set_request_interval(0);
+  efs.set_receive_timeout(200);
+  sensor::Sensor energy;
+  sensor::Sensor power;
+  sensor::Sensor voltage;
+
+  counting_allocations = true;
+  num_allocations = 0;
+  efs.add_sensor(VOLTAGE_L1, &voltage, 1);
+  efs.add_sensor(ENERGY_IMPORTED, &energy, 3);
+  efs.add_sensor(POWER_IMPORTED, &power, NO_ROUNDING);
+  efs.setup();
+  counting_allocations = false;
+  EXPECT_EQ(num_allocations, 0U);
+
+  // Receive, parse and dispatch two telegrams, the second one is unchanged
+  for (int i = 0; i < 2; ++i) {
+    uart.receive(telegram);
+    counting_allocations = true;
+    run_loop(efs, 10);
+    counting_allocations = false;
+  }
+
+  EXPECT_EQ(num_allocations, 0U);
+  EXPECT_EQ(energy.num_published, 2U);
+  EXPECT_EQ(efs.get_objects_unchanged(), 3U);
+  EXPECT_FLOAT_EQ(energy.state, 6678.394f);
+  EXPECT_FLOAT_EQ(power.state, 1.727f);
+  EXPECT_FLOAT_EQ(voltage.state, 240.3f);
+}
+
+TEST(StaticAllocationTest, FullSensorTableRejectsSensors) {
+  RecordingSensor sensor;
+  SensorTable<RecordingSensor, Entries> sensors;
+  for (size_t i = 0; i < MAX_SENSORS; ++i) {
+    EXPECT_TRUE(sensors.add(ObisCode(1, 0, static_cast<uint8_t>(i), 7, 0), &sensor, 1));
+  }
+  EXPECT_FALSE(sensors.add(ObisCode(1, 0, 0, 7, 0), &sensor, 1));
+  EXPECT_EQ(sensors.size(), MAX_SENSORS);
+}
+
+TEST(StaticVectorTest, InsertKeepsOrder) {
+  StaticVector<ObisCode, 4> codes;
+  EXPECT_TRUE(codes.empty());
+  EXPECT_EQ(codes.insert(codes.end(), VOLTAGE_L1), &codes[0]);
+  EXPECT_EQ(codes.insert(codes.begin(), ENERGY_IMPORTED), &codes[0]);
+  EXPECT_EQ(codes.insert(&codes[1], POWER_IMPORTED), &codes[1]);
+  EXPECT_TRUE(codes.push_back(CURRENT_L1));
+  ASSERT_EQ(codes.size(), 4U);
+  EXPECT_EQ(codes[0], ENERGY_IMPORTED);
+  EXPECT_EQ(codes[1], POWER_IMPORTED);
+  EXPECT_EQ(codes[2], VOLTAGE_L1);
+  EXPECT_EQ(codes.back(), CURRENT_L1);
+
+  // Full
+  EXPECT_FALSE(codes.push_back(CURRENT_L1));
+  const auto end = codes.end();
+  EXPECT_EQ(codes.insert(codes.begin(), CURRENT_L1), end);
+  EXPECT_EQ(codes.size(), 4U);
+
+  const auto copy = codes;
+  codes.clear();
+  EXPECT_TRUE(codes.empty());
+  ASSERT_EQ(copy.size(), 4U);
+  EXPECT_EQ(copy[1], POWER_IMPORTED);
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,114 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "components/efs/telegram_pool.h"
+
+namespace esphome::efs {
+namespace {
+
+TEST(TelegramPoolTest, BuffersFitTheLargestClient) {
+  TelegramPool pool;
+  const uint8_t first = pool.add_client(1000);
+  const uint8_t second = pool.add_client(1501);
+  pool.require_buffers(1);
+  pool.require_buffers(2);
+  pool.require_buffers(1);
+  pool.allocate();
+  EXPECT_EQ(pool.buffer_size(), 1504U);
+  EXPECT_EQ(pool.num_buffers(), 2U);
+
+  char *const a = pool.acquire(first, 0);
+  char *const b = pool.acquire(second, 0);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 4, 0U);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 4, 0U);
+  EXPECT_GE(static_cast<size_t>(b > a ? b - a : a - b), 1501U);
+  // Clients can not be added once the buffers are allocated
+  EXPECT_EQ(pool.add_client(100), TelegramPool::NO_CLIENT);
+}
+
+TEST(TelegramPoolTest, ReleasedBufferIsReused) {
+  TelegramPool pool;
+  const uint8_t client = pool.add_client(64);
+  pool.require_buffers(1);
+  pool.allocate();
+  char *const buffer = pool.acquire(client, 0);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(pool.acquire(client, 0), nullptr);
+  pool.release(buffer);
+  EXPECT_EQ(pool.acquire(client, 10), buffer);
+}
+
+TEST(TelegramPoolTest, RefusedClientGetsTheNextFreeBuffer) {
+  TelegramPool pool;
+  const uint8_t chatty = pool.add_client(64);
+  const uint8_t quiet = pool.add_client(64);
+  pool.require_buffers(1);
+  pool.allocate();
+
+  char *const buffer = pool.acquire(chatty, 0);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(pool.acquire(quiet, 100), nullptr);
+  EXPECT_EQ(pool.num_waiting(), 1U);
+  pool.release(buffer);
+
+  // The chatty meter starts its next telegram first, but the buffer is held for the quiet one
+  EXPECT_EQ(pool.acquire(chatty, 1000), nullptr);
+  EXPECT_EQ(pool.acquire(quiet, 5000), buffer);
+  pool.release(buffer);
+  // Then it is the chatty meter's turn
+  EXPECT_EQ(pool.acquire(quiet, 6000), nullptr);
+  EXPECT_EQ(pool.acquire(chatty, 7000), buffer);
+}
+
+TEST(TelegramPoolTest, ClientsAreServedInTheOrderTheyWereRefused) {
+  TelegramPool pool;
+  const uint8_t clients[] = {pool.add_client(64), pool.add_client(64), pool.add_client(64), pool.add_client(64)};
+  pool.require_buffers(2);
+  pool.allocate();
+
+  char *const first = pool.acquire(clients[0], 0);
+  char *const second = pool.acquire(clients[1], 0);
+  EXPECT_EQ(pool.acquire(clients[3], 1), nullptr);
+  EXPECT_EQ(pool.acquire(clients[2], 2), nullptr);
+  pool.release(first);
+  EXPECT_EQ(pool.acquire(clients[2], 3), nullptr);
+  EXPECT_NE(pool.acquire(clients[3], 4), nullptr);
+  pool.release(second);
+  EXPECT_EQ(pool.acquire(clients[0], 5), nullptr);
+  EXPECT_NE(pool.acquire(clients[2], 6), nullptr);
+  EXPECT_EQ(pool.num_waiting(), 1U);
+}
+
+TEST(TelegramPoolTest, ReservationExpires) {
+  TelegramPool pool;
+  const uint8_t chatty = pool.add_client(64);
+  const uint8_t gone = pool.add_client(64);
+  pool.require_buffers(1);
+  pool.set_reservation_timeout(1000);
+  pool.allocate();
+
+  char *const buffer = pool.acquire(chatty, 0);
+  EXPECT_EQ(pool.acquire(gone, 100), nullptr);
+  pool.release(buffer);
+  EXPECT_EQ(pool.acquire(chatty, 1000), nullptr);
+  // The refused meter has not asked again within the timeout, the wait of the chatty meter is still recent
+  EXPECT_EQ(pool.acquire(chatty, 1101), buffer);
+  EXPECT_EQ(pool.num_waiting(), 0U);
+}
+
+TEST(TelegramPoolTest, UnknownClientIsRefused) {
+  TelegramPool pool;
+  pool.add_client(64);
+  pool.require_buffers(1);
+  EXPECT_EQ(pool.acquire(0, 0), nullptr);
+  pool.allocate();
+  EXPECT_EQ(pool.acquire(1, 0), nullptr);
+  EXPECT_EQ(pool.acquire(TelegramPool::NO_CLIENT, 0), nullptr);
+  EXPECT_NE(pool.acquire(0, 0), nullptr);
+}
+
+}  // namespace
+}  // namespace esphome::efs
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "components/efs/object.h"
+#include "components/efs/timestamp.h"
+
+namespace esphome::efs {
+namespace {
+
+constexpr int32_t CET = 3600;
+
+Timestamp parse(const char *data) {
+  Timestamp timestamp{0, false};
+  EXPECT_TRUE(parse_timestamp(data, strlen(data), timestamp)) << data;
+  return timestamp;
+}
+
+bool is_timestamp(const char *data) {
+  Timestamp timestamp{0, false};
+  return parse_timestamp(data, strlen(data), timestamp);
+}
+
+TEST(TimestampTest, ConvertsWinterTimeToEpoch) {
+  const auto timestamp = parse("101209113020W");
+  EXPECT_FALSE(timestamp.dst);
+  EXPECT_EQ(timestamp.to_epoch(CET), 1291890620);
+}
+
+TEST(TimestampTest, ConvertsSummerTimeToEpoch) {
+  const auto timestamp = parse("200701120000S");
+  EXPECT_TRUE(timestamp.dst);
+  EXPECT_EQ(timestamp.to_epoch(CET), 1593597600);
+}
+
+TEST(TimestampTest, ParsesTimestampWithoutDstFlag) {
+  const auto timestamp = parse("090212160000");
+  EXPECT_FALSE(timestamp.dst);
+  EXPECT_EQ(timestamp.to_epoch(0), 1234454400);
+}
+
+TEST(TimestampTest, HandlesCenturyBounds) {
+  EXPECT_EQ(parse("000101000000W").to_epoch(0), 946684800);
+  EXPECT_EQ(parse("991231235959W").to_epoch(0), 4102444799);
+}
+
+TEST(TimestampTest, HandlesLeapDays) {
+  EXPECT_EQ(parse("240229000000W").to_epoch(0), 1709164800);
+  EXPECT_EQ(parse("240301000000W").to_epoch(0), 1709164800 + 86400);
+  EXPECT_TRUE(is_timestamp("000229000000W"));
+  EXPECT_FALSE(is_timestamp("230229000000W"));
+}
+
+TEST(TimestampTest, RejectsInvalidTimestamps) {
+  EXPECT_FALSE(is_timestamp(""));
+  EXPECT_FALSE(is_timestamp("10120911302"));
+  EXPECT_FALSE(is_timestamp("101209113020WW"));
+  EXPECT_FALSE(is_timestamp("101209113020X"));
+  EXPECT_FALSE(is_timestamp("10120911302aW"));
+  EXPECT_FALSE(is_timestamp("101309113020W"));
+  EXPECT_FALSE(is_timestamp("100009113020W"));
+  EXPECT_FALSE(is_timestamp("101200113020W"));
+  EXPECT_FALSE(is_timestamp("100431113020W"));
+  EXPECT_FALSE(is_timestamp("101209243020W"));
+  EXPECT_FALSE(is_timestamp("101209116020W"));
+  EXPECT_FALSE(is_timestamp("101209113060W"));
+  EXPECT_FALSE(is_timestamp("12785.123*m3"));
+}
+
+TEST(TimestampTest, ComparesTimestamps) {
+  EXPECT_EQ(parse("101209110000W"), parse("101209110000W"));
+  EXPECT_NE(parse("101209110000W"), parse("101209120000W"));
+  EXPECT_NE(parse("101209110000W"), parse("101209110000S"));
+}
+
+TEST(TimestampTest, ObjectDecodesTimestampAtIndex) {
+  const char data[] = "101209110000W\0" "12785.123*m3";
+  const Object object(ObisCode(0, 1, 24, 2, 1), 2, std::string_view(data, sizeof(data)));
+  ASSERT_TRUE(object.timestamp().has_value());
+  EXPECT_EQ(object.timestamp()->to_epoch(CET), 1291888800);
+  EXPECT_FALSE(object.timestamp(1).has_value());
+  EXPECT_FALSE(object.timestamp(2).has_value());
+}
+
+}  // namespace
+}  // namespace esphome::efs